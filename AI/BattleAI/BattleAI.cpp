@@ -17,6 +17,8 @@
 #include "tbb/parallel_for.h"
 #include "../../lib/CStopWatch.h"
 #include "../../lib/CThreadHelper.h"
+#include "../../lib/PerformanceStatistics.h"
+#include "../../lib/ScopeGuard.h"
 #include "../../lib/mapObjects/CGTownInstance.h"
 #include "../../lib/spells/CSpellHandler.h"
 #include "../../lib/spells/ISpellMechanics.h"
@@ -41,6 +43,9 @@ CBattleAI::CBattleAI()
 
 CBattleAI::~CBattleAI()
 {
+	if(battleThinkingTime.count() != 0)
+		PerformanceStatistics::getInstance().addTime("BattleAI::battle", battleThinkingTime);
+
 	if(cb)
 	{
 		//Restore previous state of CB - it may be shared with the main AI (like VCAI)
@@ -143,6 +148,13 @@ void CBattleAI::activeStack(const BattleID & battleID, const CStack * stack )
 
 	auto start = std::chrono::high_resolution_clock::now();
 
+	auto recordThinkingTime = vstd::makeScopeGuard([this, start]()
+	{
+		auto duration = std::chrono::high_resolution_clock::now() - start;
+		battleThinkingTime += duration;
+		PerformanceStatistics::getInstance().addTime("BattleAI::activeStack", duration);
+	});
+
 	try
 	{
 		if(stack->creatureId() == CreatureID::CATAPULT)
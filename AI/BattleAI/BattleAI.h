@@ -63,6 +63,8 @@ class CBattleAI : public CBattleGameInterface
 	bool wasUnlockingGs;
 	int movesSkippedByDefense;
 	bool skipCastUntilNextBattle;
+	/// Total time spent on decisions in this battle, for performance statistics
+	std::chrono::nanoseconds battleThinkingTime{0};
 
 public:
 	CBattleAI();
@@ -10,6 +10,7 @@
 #include "StdInc.h"
 #include "BattleExchangeVariant.h"
 #include "../../lib/CStack.h"
+#include "tbb/parallel_for.h"
 
 AttackerValue::AttackerValue()
 	: value(0),
@@ -229,14 +230,16 @@ EvaluationResult BattleExchangeEvaluator::findBestTarget(
 
 		updateReachabilityMap(hbWaited);
 
-		for(auto & ap : targets.possibleAttacks)
+		auto scores = evaluateExchanges(targets.possibleAttacks, targets, damageCache, hbWaited);
+
+		for(size_t i = 0; i < scores.size(); i++)
 		{
-			float score = evaluateExchange(ap, 0, targets, damageCache, hbWaited);
+			float score = scores[i];
 
 			if(score > result.score)
 			{
 				result.score = score;
-				result.bestAttack = ap;
+				result.bestAttack = targets.possibleAttacks[i];
 				result.wait = true;
 
 #if BATTLE_TRACE_LEVEL >= 1
@@ -261,15 +264,17 @@ EvaluationResult BattleExchangeEvaluator::findBestTarget(
 			return result; // lets wait
 	}
 
-	for(auto & ap : targets.possibleAttacks)
+	auto scores = evaluateExchanges(targets.possibleAttacks, targets, damageCache, hb);
+
+	for(size_t i = 0; i < scores.size(); i++)
 	{
-		float score = evaluateExchange(ap, 0, targets, damageCache, hb);
+		float score = scores[i];
 		bool sameScoreButWaited = vstd::isAlmostEqual(score, result.score) && result.wait;
 
 		if(score > result.score || sameScoreButWaited)
 		{
 			result.score = score;
-			result.bestAttack = ap;
+			result.bestAttack = targets.possibleAttacks[i];
 			result.wait = false;
 
 #if BATTLE_TRACE_LEVEL >= 1
@@ -281,6 +286,45 @@ EvaluationResult BattleExchangeEvaluator::findBestTarget(
 	return result;
 }
 
+std::vector<float> BattleExchangeEvaluator::evaluateExchanges(
+	const std::vector<AttackPossibility> & attacks,
+	PotentialTargets & targets,
+	DamageCache & damageCache,
+	std::shared_ptr<HypotheticBattle> hb) const
+{
+	std::vector<float> scores(attacks.size());
+
+#if BATTLE_TRACE_LEVEL >= 1
+	tbb::blocked_range<size_t> r(0, attacks.size());
+#else
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, attacks.size()), [&](const tbb::blocked_range<size_t> & r)
+		{
+#endif
+			DamageCache workerCache = damageCache;
+
+			for(auto i = r.begin(); i != r.end(); i++)
+			{
+				scores[i] = evaluateExchange(attacks[i], 0, targets, workerCache, hb);
+			}
+#if BATTLE_TRACE_LEVEL == 0
+		});
+#endif
+
+	return scores;
+}
+
+std::shared_ptr<HypotheticBattle> BattleExchangeEvaluator::getExchangeBattle(std::shared_ptr<HypotheticBattle> hb) const
+{
+	auto & exchangeBattle = exchangeBattles.local();
+
+	if(exchangeBattle)
+		exchangeBattle->resetState(hb);
+	else
+		exchangeBattle = std::make_shared<HypotheticBattle>(env.get(), hb);
+
+	return exchangeBattle;
+}
+
 ReachabilityInfo getReachabilityWithEnemyBypass(
 	const battle::Unit * activeStack,
 	DamageCache & damageCache,
@@ -302,7 +346,7 @@ ReachabilityInfo getReachabilityWithEnemyBypass(
 
 			for(auto & hex : unit->getHexes())
 				if(hex.isAvailable()) //towers can have <0 pos; we don't also want to overwrite side columns
-					params.destructibleEnemyTurns[hex] = turnsToKill * unit->getMovementRange();
+					params.destructibleEnemyTurns.set(hex, turnsToKill * unit->getMovementRange());
 		}
 
 		params.bypassEnemyStacks = true;
@@ -335,6 +379,18 @@ MoveTarget BattleExchangeEvaluator::findMoveTowardsUnreachable(
 	auto dists = getReachabilityWithEnemyBypass(activeStack, damageCache, hb);
 	auto flying = activeStack->hasBonusOfType(BonusType::FLYING);
 
+	struct MoveCandidate
+	{
+		const battle::Unit * enemy;
+		BattleHex hex;
+		uint8_t turnsToRich;
+		float multiplier;
+		std::optional<AttackPossibility> attack;
+		BattleScore score;
+	};
+
+	std::vector<MoveCandidate> candidates;
+
 	for(const battle::Unit * enemy : targets.unreachableEnemies)
 	{
 		logAi->trace(
@@ -357,84 +413,107 @@ MoveTarget BattleExchangeEvaluator::findMoveTowardsUnreachable(
 		auto multiplier = speedRatio > 1 ? 1 : speedRatio;
 
 		for(auto & hex : hexes)
+			candidates.push_back(MoveCandidate{enemy, hex, static_cast<uint8_t>(turnsToRich), multiplier});
+	}
+
+	// exchanges are independent so they are simulated in parallel, best one is selected in original order below
+#if BATTLE_TRACE_LEVEL >= 1
+	tbb::blocked_range<size_t> r(0, candidates.size());
+#else
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, candidates.size()), [&](const tbb::blocked_range<size_t> & r)
 		{
-			// FIXME: provide distance info for Jousting bonus
-			auto bai = BattleAttackInfo(activeStack, enemy, 0, cb->battleCanShoot(activeStack));
-			auto attack = AttackPossibility::evaluate(bai, hex, damageCache, hb);
+#endif
+			DamageCache workerCache = damageCache;
 
-			attack.shootersBlockedDmg = 0; // we do not want to count on it, it is not for sure
+			for(auto i = r.begin(); i != r.end(); i++)
+			{
+				auto & candidate = candidates[i];
 
-			auto score = calculateExchange(attack, turnsToRich, targets, damageCache, hb);
+				// FIXME: provide distance info for Jousting bonus
+				auto bai = BattleAttackInfo(activeStack, candidate.enemy, 0, cb->battleCanShoot(activeStack));
+
+				candidate.attack = AttackPossibility::evaluate(bai, candidate.hex, workerCache, hb);
+				candidate.attack->shootersBlockedDmg = 0; // we do not want to count on it, it is not for sure
+				candidate.score = calculateExchange(*candidate.attack, candidate.turnsToRich, targets, workerCache, hb);
+				candidate.score.enemyDamageReduce *= candidate.multiplier;
+			}
+#if BATTLE_TRACE_LEVEL == 0
+		});
+#endif
 
-			score.enemyDamageReduce *= multiplier;
+	for(auto & candidate : candidates)
+	{
+		const battle::Unit * enemy = candidate.enemy;
+		const AttackPossibility & attack = *candidate.attack;
+		auto turnsToRich = candidate.turnsToRich;
+		auto & score = candidate.score;
 
 #if BATTLE_TRACE_LEVEL >= 1
-			logAi->trace("Multiplier: %f, turns: %d, current score %f, new score %f", multiplier, turnsToRich, result.score, scoreValue(score));
+		logAi->trace("Multiplier: %f, turns: %d, current score %f, new score %f", candidate.multiplier, turnsToRich, result.score, scoreValue(score));
 #endif
 
-			if(result.score < scoreValue(score)
-				|| (result.turnsToRich > turnsToRich && vstd::isAlmostEqual(result.score, scoreValue(score))))
-			{
-				result.score = scoreValue(score);
-				result.positions.clear();
+		if(result.score < scoreValue(score)
+			|| (result.turnsToRich > turnsToRich && vstd::isAlmostEqual(result.score, scoreValue(score))))
+		{
+			result.score = scoreValue(score);
+			result.positions.clear();
 
 #if BATTLE_TRACE_LEVEL >= 1
-				logAi->trace("New high score");
+			logAi->trace("New high score");
 #endif
 
-				for(const BattleHex & initialEnemyHex : enemy->getAttackableHexes(activeStack))
+			for(const BattleHex & initialEnemyHex : enemy->getAttackableHexes(activeStack))
+			{
+				BattleHex enemyHex = initialEnemyHex;
+
+				while(!flying && dists.distances[enemyHex] > speed && dists.predecessors.at(enemyHex).isValid())
 				{
-					BattleHex enemyHex = initialEnemyHex;
+					enemyHex = dists.predecessors.at(enemyHex);
 
-					while(!flying && dists.distances[enemyHex] > speed && dists.predecessors.at(enemyHex).isValid())
+					if(dists.accessibility[enemyHex] == EAccessibility::ALIVE_STACK)
 					{
-						enemyHex = dists.predecessors.at(enemyHex);
+						auto defenderToBypass = hb->battleGetUnitByPos(enemyHex);
 
-						if(dists.accessibility[enemyHex] == EAccessibility::ALIVE_STACK)
+						if(defenderToBypass)
 						{
-							auto defenderToBypass = hb->battleGetUnitByPos(enemyHex);
-
-							if(defenderToBypass)
-							{
 #if BATTLE_TRACE_LEVEL >= 1
-								logAi->trace("Found target to bypass at %d", enemyHex.hex);
+							logAi->trace("Found target to bypass at %d", enemyHex.hex);
 #endif
 
-								auto attackHex = dists.predecessors[enemyHex];
-								auto baiBypass = BattleAttackInfo(activeStack, defenderToBypass, 0, cb->battleCanShoot(activeStack));
-								auto attackBypass = AttackPossibility::evaluate(baiBypass, attackHex, damageCache, hb);
+							auto attackHex = dists.predecessors[enemyHex];
+							auto baiBypass = BattleAttackInfo(activeStack, defenderToBypass, 0, cb->battleCanShoot(activeStack));
+							auto attackBypass = AttackPossibility::evaluate(baiBypass, attackHex, damageCache, hb);
 
-								auto adjacentStacks = getAdjacentUnits(enemy);
+							auto adjacentStacks = getAdjacentUnits(enemy);
 
-								adjacentStacks.push_back(defenderToBypass);
-								vstd::removeDuplicates(adjacentStacks);
+							adjacentStacks.push_back(defenderToBypass);
+							vstd::removeDuplicates(adjacentStacks);
 
-								auto bypassScore = calculateExchange(
-									attackBypass,
-									dists.distances[attackHex],
-									targets,
-									damageCache,
-									hb,
-									adjacentStacks);
+							auto bypassScore = calculateExchange(
+								attackBypass,
+								dists.distances[attackHex],
+								targets,
+								damageCache,
+								hb,
+								adjacentStacks);
 
-								if(scoreValue(bypassScore) > result.score)
-								{
-									result.score = scoreValue(bypassScore);
+							if(scoreValue(bypassScore) > result.score)
+							{
+								result.score = scoreValue(bypassScore);
 
 #if BATTLE_TRACE_LEVEL >= 1
-									logAi->trace("New high score after bypass %f", scoreValue(bypassScore));
+								logAi->trace("New high score after bypass %f", scoreValue(bypassScore));
 #endif
-								}
 							}
 						}
 					}
-
-					result.positions.push_back(enemyHex);
 				}
 
-				result.cachedAttack = attack;
-				result.turnsToRich = turnsToRich;
+				result.positions.push_back(enemyHex);
 			}
+
+			result.cachedAttack = attack;
+			result.turnsToRich = turnsToRich;
 		}
 	}
 
@@ -631,7 +710,7 @@ BattleScore BattleExchangeEvaluator::calculateExchange(
 		return BattleScore();
 	}
 
-	auto exchangeBattle = std::make_shared<HypotheticBattle>(env.get(), hb);
+	auto exchangeBattle = getExchangeBattle(hb);
 	BattleExchangeVariant v;
 
 	for(int exchangeTurn = 0; exchangeTurn < exchangeUnits.units.size(); exchangeTurn++)
@@ -828,15 +907,6 @@ BattleScore BattleExchangeEvaluator::calculateExchange(
 		exchangeBattle->nextRound();
 	}
 
-	// avoid blocking path for stronger stack by weaker stack
-	// the method checks if all stacks can be placed around enemy
-	std::map<BattleHex, battle::Units> reachabilityMap;
-
-	auto hexes = ap.attack.defender->getSurroundingHexes();
-
-	for(auto hex : hexes)
-		reachabilityMap[hex] = getOneTurnReachableUnits(turn, hex);
-
 	auto score = v.getScore();
 
 	if(simulationTurnsCount < totalTurnsCount)
@@ -865,7 +935,7 @@ bool BattleExchangeEvaluator::canBeHitThisTurn(const AttackPossibility & ap)
 {
 	for(auto pos : ap.attack.attacker->getSurroundingHexes())
 	{
-		for(auto u : reachabilityMap[pos])
+		for(auto u : reachabilityMap.at(pos))
 		{
 			if(u->unitSide() != ap.attack.attacker->unitSide())
 			{
@@ -889,7 +959,7 @@ void BattleExchangeEvaluator::updateReachabilityMap(std::shared_ptr<HypotheticBa
 	{
 		for(auto u : turn)
 		{
-			if(!vstd::contains(reachabilityCache, u->unitId()))
+			if(!reachabilityCache.count(u->unitId()))
 			{
 				reachabilityCache[u->unitId()] = hb->getReachability(u);
 			}
@@ -898,18 +968,18 @@ void BattleExchangeEvaluator::updateReachabilityMap(std::shared_ptr<HypotheticBa
 
 	for(BattleHex hex = BattleHex::TOP_LEFT; hex.isValid(); hex = hex + 1)
 	{
-		reachabilityMap[hex] = getOneTurnReachableUnits(0, hex);
+		reachabilityMap[hex.hex] = getOneTurnReachableUnits(0, hex);
 	}
 }
 
 std::vector<const battle::Unit *> BattleExchangeEvaluator::getOneTurnReachableUnits(uint8_t turn, BattleHex hex) const
 {
 	std::vector<const battle::Unit *> result;
+	HypotheticBattle turnBattle(env.get(), cb);
 
 	for(int i = 0; i < turnOrder.size(); i++, turn++)
 	{
 		auto & turnQueue = turnOrder[i];
-		HypotheticBattle turnBattle(env.get(), cb);
 
 		for(const battle::Unit * unit : turnQueue)
 		{
@@ -929,7 +999,12 @@ std::vector<const battle::Unit *> BattleExchangeEvaluator::getOneTurnReachableUn
 			auto reachabilityIter = reachabilityCache.find(unit->unitId());
 			assert(reachabilityIter != reachabilityCache.end()); // missing updateReachabilityMap call?
 
-			ReachabilityInfo unitReachability = reachabilityIter != reachabilityCache.end() ? reachabilityIter->second : turnBattle.getReachability(unit);
+			std::optional<ReachabilityInfo> missingReachability;
+
+			if(reachabilityIter == reachabilityCache.end())
+				missingReachability = turnBattle.getReachability(unit);
+
+			const ReachabilityInfo & unitReachability = missingReachability ? *missingReachability : reachabilityIter->second;
 
 			bool reachable = unitReachability.distances.at(hex) <= radius;
 
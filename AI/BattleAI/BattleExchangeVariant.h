@@ -14,6 +14,9 @@
 #include "PotentialTargets.h"
 #include "StackWithBonuses.h"
 
+#include <boost/container/flat_map.hpp>
+#include <tbb/enumerable_thread_specific.h>
+
 struct BattleScore
 {
 	float ourDamageReduce;
@@ -128,14 +131,26 @@ class BattleExchangeEvaluator
 private:
 	std::shared_ptr<CBattleInfoCallback> cb;
 	std::shared_ptr<Environment> env;
-	std::map<uint32_t, ReachabilityInfo> reachabilityCache;
-	std::map<BattleHex, std::vector<const battle::Unit *>> reachabilityMap;
+	boost::container::flat_map<uint32_t, ReachabilityInfo> reachabilityCache;
+	std::array<std::vector<const battle::Unit *>, GameConstants::BFIELD_SIZE> reachabilityMap;
 	std::vector<battle::Units> turnOrder;
 	float negativeEffectMultiplier;
 	int simulationTurnsCount;
 
+	/// Hypothetic battle of each worker thread, reset before every exchange simulation
+	mutable tbb::enumerable_thread_specific<std::shared_ptr<HypotheticBattle>> exchangeBattles;
+
 	float scoreValue(const BattleScore & score) const;
 
+	std::shared_ptr<HypotheticBattle> getExchangeBattle(std::shared_ptr<HypotheticBattle> hb) const;
+
+	/// Evaluates all attacks in parallel, each worker uses own copy of damage cache
+	std::vector<float> evaluateExchanges(
+		const std::vector<AttackPossibility> & attacks,
+		PotentialTargets & targets,
+		DamageCache & damageCache,
+		std::shared_ptr<HypotheticBattle> hb) const;
+
 	BattleScore calculateExchange(
 		const AttackPossibility & ap,
 		uint8_t turn,
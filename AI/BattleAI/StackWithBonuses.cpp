@@ -144,27 +144,25 @@ TConstBonusListPtr StackWithBonuses::getAllBonuses(const CSelector & selector, c
 	});
 
 
-	for(const Bonus & bonus : bonusesToUpdate)
+	for(const auto & bonus : bonusesToUpdate)
 	{
-		if(selector(&bonus) && (!limit || limit(&bonus)))
+		if(selector(bonus.get()) && (!limit || limit(bonus.get())))
 		{
-			if(ret->getFirst(Selector::source(BonusSource::SPELL_EFFECT, bonus.sid).And(Selector::typeSubtype(bonus.type, bonus.subtype))))
+			if(ret->getFirst(Selector::source(BonusSource::SPELL_EFFECT, bonus->sid).And(Selector::typeSubtype(bonus->type, bonus->subtype))))
 			{
-				actualizeEffect(ret, bonus);
+				actualizeEffect(ret, *bonus);
 			}
 			else
 			{
-				auto b = std::make_shared<Bonus>(bonus);
-				ret->push_back(b);
+				ret->push_back(bonus);
 			}
 		}
 	}
 
-	for(auto & bonus : bonusesToAdd)
+	for(const auto & bonus : bonusesToAdd)
 	{
-		auto b = std::make_shared<Bonus>(bonus);
-		if(selector(b.get()) && (!limit || !limit(b.get())))
-			ret->push_back(b);
+		if(selector(bonus.get()) && (!limit || !limit(bonus.get())))
+			ret->push_back(bonus);
 	}
 	//TODO limiters?
 	return ret;
@@ -182,7 +180,9 @@ int64_t StackWithBonuses::getTreeVersion() const
 
 void StackWithBonuses::addUnitBonus(const std::vector<Bonus> & bonus)
 {
-	vstd::concatenate(bonusesToAdd, bonus);
+	// bonuses are allocated once here and shared by all following queries instead of being copied on each query
+	for(const auto & one : bonus)
+		bonusesToAdd.push_back(std::make_shared<Bonus>(one));
 	treeVersionLocal++;
 }
 
@@ -190,7 +190,8 @@ void StackWithBonuses::updateUnitBonus(const std::vector<Bonus> & bonus)
 {
 	//TODO: optimize, actualize to last value
 
-	vstd::concatenate(bonusesToUpdate, bonus);
+	for(const auto & one : bonus)
+		bonusesToUpdate.push_back(std::make_shared<Bonus>(one));
 	treeVersionLocal++;
 }
 
@@ -223,8 +224,8 @@ void StackWithBonuses::removeUnitBonus(const CSelector & selector)
 	for(auto b : *toRemove)
 		bonusesToRemove.insert(b);
 
-	vstd::erase_if(bonusesToAdd, [&](const Bonus & b){return selector(&b);});
-	vstd::erase_if(bonusesToUpdate, [&](const Bonus & b){return selector(&b);});
+	vstd::erase_if(bonusesToAdd, [&](const std::shared_ptr<Bonus> & b){return selector(b.get());});
+	vstd::erase_if(bonusesToUpdate, [&](const std::shared_ptr<Bonus> & b){return selector(b.get());});
 
 	treeVersionLocal++;
 }
@@ -269,6 +270,20 @@ HypotheticBattle::HypotheticBattle(const Environment * ENV, Subject realBattle)
 #endif
 }
 
+void HypotheticBattle::resetState(Subject realBattle)
+{
+	subject = std::move(realBattle);
+	stackStates.clear();
+
+	auto activeUnit = subject->battleActiveUnit();
+	activeUnitId = activeUnit ? activeUnit->unitId() : -1;
+
+	nextId = 0x00F00000;
+
+	// units created from now on must not reuse bonus caches of previous evaluation
+	bonusTreeVersion++;
+}
+
 bool HypotheticBattle::unitHasAmmoCart(const battle::Unit * unit) const
 {
 	//FIXME: check ammocart alive state here
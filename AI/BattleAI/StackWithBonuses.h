@@ -64,8 +64,8 @@ public:
 class StackWithBonuses : public battle::CUnitState, public virtual IBonusBearer
 {
 public:
-	std::vector<Bonus> bonusesToAdd;
-	std::vector<Bonus> bonusesToUpdate;
+	std::vector<std::shared_ptr<Bonus>> bonusesToAdd;
+	std::vector<std::shared_ptr<Bonus>> bonusesToUpdate;
 	std::set<std::shared_ptr<Bonus>> bonusesToRemove;
 	int treeVersionLocal;
 
@@ -171,6 +171,10 @@ public:
 		activeUnitId = -1;
 	}
 
+	/// Drops all hypothetic changes and starts over from given battle state.
+	/// Keeps environment, server callback and event bus so instance can be reused for many evaluations
+	void resetState(Subject realBattle);
+
 #if SCRIPTING_ENABLED
 	scripting::Pool * getContextPool() const override;
 #endif
@@ -107,6 +107,11 @@ void AIGateway::heroMoved(const TryMoveHero & details, bool verbose)
 	const CGObjectInstance * o1 = vstd::frontOrNull(cb->getVisitableObjs(from, verbose));
 	const CGObjectInstance * o2 = vstd::frontOrNull(cb->getVisitableObjs(to, verbose));
 
+	nullkiller->pathfinder->invalidateAccessibility(std::unordered_set<int3>{from, to});
+
+	if(!hero || cb->getPlayerRelations(hero->tempOwner, playerID) == PlayerRelations::ENEMIES)
+		nullkiller->dangerHitMap->resetHero(details.id);
+
 	if(details.result == TryMoveHero::TELEPORTATION)
 	{
 		auto t1 = dynamic_cast<const CGTeleport *>(o1);
@@ -139,6 +144,8 @@ void AIGateway::heroInGarrisonChange(const CGTownInstance * town)
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+
+	nullkiller->pathfinder->invalidateAccessibility(town);
 }
 
 void AIGateway::centerView(int3 pos, int focusTime)
@@ -252,6 +259,10 @@ void AIGateway::heroVisit(const CGHeroInstance * visitor, const CGObjectInstance
 	{
 		nullkiller->memory->markObjectVisited(visitedObj);
 		nullkiller->objectClusterizer->invalidate(visitedObj->id);
+
+		// border gates of this color may become passable anywhere on map
+		if(visitedObj->ID == Obj::KEYMASTER)
+			nullkiller->pathfinder->invalidateAccessibility();
 	}
 
 	status.heroVisit(visitedObj, start);
@@ -275,6 +286,7 @@ void AIGateway::tileHidden(const std::unordered_set<int3> & pos)
 	NET_EVENT_HANDLER;
 
 	nullkiller->memory->removeInvisibleObjects(myCb.get());
+	nullkiller->pathfinder->invalidateAccessibility(pos);
 }
 
 void AIGateway::tileRevealed(const std::unordered_set<int3> & pos)
@@ -286,6 +298,8 @@ void AIGateway::tileRevealed(const std::unordered_set<int3> & pos)
 		for(const CGObjectInstance * obj : myCb->getVisitableObjs(tile))
 			addVisitableObj(obj);
 	}
+
+	nullkiller->pathfinder->invalidateAccessibility(pos);
 }
 
 void AIGateway::heroExchangeStarted(ObjectInstanceID hero1, ObjectInstanceID hero2, QueryID query)
@@ -353,6 +367,18 @@ void AIGateway::garrisonsChanged(ObjectInstanceID id1, ObjectInstanceID id2)
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+
+	// empty garrison is passable for everyone
+	for(auto id : {id1, id2})
+	{
+		auto obj = myCb->getObj(id, false);
+
+		if(obj)
+			nullkiller->pathfinder->invalidateAccessibility(obj);
+
+		if(obj && obj->ID == Obj::HERO && cb->getPlayerRelations(obj->tempOwner, playerID) == PlayerRelations::ENEMIES)
+			nullkiller->dangerHitMap->resetHero(id);
+	}
 }
 
 void AIGateway::newObject(const CGObjectInstance * obj)
@@ -361,6 +387,14 @@ void AIGateway::newObject(const CGObjectInstance * obj)
 	NET_EVENT_HANDLER;
 	if(obj->isVisitable())
 		addVisitableObj(obj);
+
+	nullkiller->pathfinder->invalidateAccessibility(obj);
+	nullkiller->dangerHitMap->resetObject(obj);
+
+	if(nullkiller->baseGraph && nullkiller->isObjectGraphAllowed())
+	{
+		nullkiller->baseGraph->markObjectAdded(obj);
+	}
 }
 
 //to prevent AI from accessing objects that got deleted while they became invisible (Cover of Darkness, enemy hero moved etc.) below code allows AI to know deletion of objects out of sight
@@ -375,6 +409,7 @@ void AIGateway::objectRemoved(const CGObjectInstance * obj, const PlayerColor &
 
 	nullkiller->memory->removeFromMemory(obj);
 	nullkiller->objectClusterizer->onObjectRemoved(obj->id);
+	nullkiller->pathfinder->invalidateAccessibility(obj);
 
 	if(nullkiller->baseGraph && nullkiller->isObjectGraphAllowed())
 	{
@@ -386,6 +421,9 @@ void AIGateway::objectRemoved(const CGObjectInstance * obj, const PlayerColor &
 		lostHero(cb->getHero(obj->id)); //we can promote, since objectRemoved is called just before actual deletion
 	}
 
+	// removed object may have blocked paths of enemy heroes
+	nullkiller->dangerHitMap->resetObject(obj);
+
 	if(obj->ID == Obj::HERO && cb->getPlayerRelations(obj->tempOwner, playerID) == PlayerRelations::ENEMIES)
 	{
 		nullkiller->dangerHitMap->reset();
@@ -408,6 +446,9 @@ void AIGateway::heroCreated(const CGHeroInstance * h)
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+
+	if(cb->getPlayerRelations(h->tempOwner, playerID) == PlayerRelations::ENEMIES)
+		nullkiller->dangerHitMap->resetHero(h->id);
 }
 
 void AIGateway::advmapSpellCast(const CGHeroInstance * caster, SpellID spellID)
@@ -486,6 +527,21 @@ void AIGateway::objectPropertyChanged(const SetObjectProperty * sop)
 {
 	LOG_TRACE(logAi);
 	NET_EVENT_HANDLER;
+
+	// owner or quest state affect whether object is passable
+	if(nullkiller)
+	{
+		auto changedObj = myCb->getObj(sop->id, false);
+
+		if(changedObj)
+		{
+			nullkiller->pathfinder->invalidateAccessibility(changedObj);
+
+			if(sop->what == ObjProperty::OWNER)
+				nullkiller->dangerHitMap->resetObject(changedObj);
+		}
+	}
+
 	if(sop->what == ObjProperty::OWNER)
 	{
 		auto relations = myCb->getPlayerRelations(playerID, sop->identifier.as<PlayerColor>());
@@ -583,6 +639,8 @@ void AIGateway::yourTurn(QueryID queryID)
 {
 	LOG_TRACE_PARAMS(logAi, "queryID '%i'", queryID);
 	NET_EVENT_HANDLER;
+	// changes of invisible garrisons are not reported, so accessibility is refreshed once per turn
+	nullkiller->pathfinder->invalidateAccessibility();
 	status.addQuery(queryID, "YourTurn");
 	requestActionASAP([=](){ answerQuery(queryID, 0); });
 	status.startedTurn();
@@ -1172,6 +1230,9 @@ void AIGateway::battleEnd(const BattleID & battleID, const BattleResult * br, Qu
 	logAi->debug("Player %d (%s): I %s the %s!", playerID, playerID.toString(), (won ? "won" : "lost"), battlename);
 	battlename.clear();
 
+	// battle may have changed garrisons and guards that are not reported separately
+	nullkiller->pathfinder->invalidateAccessibility();
+
 	CAdventureAI::battleEnd(battleID, br, queryID);
 
 	// gosolo
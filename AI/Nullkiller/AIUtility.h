@@ -36,6 +36,7 @@
 #include "tbb/concurrent_vector.h"
 #include "tbb/parallel_for.h"
 #include "tbb/parallel_invoke.h"
+#include "tbb/task_arena.h"
 
 /*********************** TBB.h ********************/
 
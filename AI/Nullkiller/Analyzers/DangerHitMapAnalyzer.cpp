@@ -60,6 +60,86 @@ void logHitmap(PlayerColor playerID, DangerHitMapAnalyzer & data)
 #endif
 }
 
+/// Index of tile in hit map storage, tiles of one range of indexes are merged by one thread
+uint32_t getTileIndex(const int3 & pos, const int3 & mapSize)
+{
+	return (pos.x * mapSize.y + pos.y) * mapSize.z + pos.z;
+}
+
+bool isMovingOnLand(const CGHeroInstance * hero)
+{
+	return !hero->boat || hero->boat->layer != EPathfindingLayer::SAIL;
+}
+
+EnemyHeroThreats::EnemyHeroThreats(const CGHeroInstance * hero)
+	:hero(hero),
+	owner(hero->tempOwner),
+	position(hero->visitablePos()),
+	strength(hero->getTotalStrength()),
+	mana(hero->mana),
+	movement(hero->movementPointsLimit(isMovingOnLand(hero))),
+	inBoat(hero->boat != nullptr)
+{
+}
+
+bool EnemyHeroThreats::isOutdated(const CGHeroInstance * hero) const
+{
+	return owner != hero->tempOwner
+		|| position != hero->visitablePos()
+		|| strength != hero->getTotalStrength()
+		|| mana != hero->mana
+		|| movement != hero->movementPointsLimit(isMovingOnLand(hero))
+		|| inBoat != (hero->boat != nullptr);
+}
+
+const EnemyHeroThreats::TileThreat * EnemyHeroThreats::findTile(uint32_t tileIndex) const
+{
+	auto tile = std::lower_bound(tiles.begin(), tiles.end(), tileIndex, [](const TileThreat & t, uint32_t index) -> bool
+		{
+			return t.tileIndex < index;
+		});
+
+	return tile != tiles.end() && tile->tileIndex == tileIndex ? &*tile : nullptr;
+}
+
+HitMapInfo EnemyHeroThreats::getMaximumDanger(const TileThreat & tile) const
+{
+	HitMapInfo result;
+
+	result.hero = hero;
+	result.danger = tile.maximumDanger;
+	result.turn = tile.maximumDangerTurn;
+	result.threat = tile.maximumDangerThreat;
+
+	return result;
+}
+
+HitMapInfo EnemyHeroThreats::getFastestDanger(const TileThreat & tile) const
+{
+	HitMapInfo result;
+
+	result.hero = hero;
+	result.danger = tile.fastestDanger;
+	result.turn = tile.fastestDangerTurn;
+	result.threat = tile.fastestDangerThreat;
+
+	return result;
+}
+
+void updateHitMapNode(HitMapNode & node, const HitMapInfo & maximumDanger, const HitMapInfo & fastestDanger)
+{
+	if(maximumDanger.value() > node.maximumDanger.value())
+	{
+		node.maximumDanger = maximumDanger;
+	}
+
+	if(fastestDanger.turn < node.fastestDanger.turn
+		|| (fastestDanger.turn == node.fastestDanger.turn && node.fastestDanger.danger < fastestDanger.danger))
+	{
+		node.fastestDanger = fastestDanger;
+	}
+}
+
 void DangerHitMapAnalyzer::updateHitMap()
 {
 	if(hitMapUpToDate)
@@ -70,14 +150,13 @@ void DangerHitMapAnalyzer::updateHitMap()
 	hitMapUpToDate = true;
 	auto start = std::chrono::high_resolution_clock::now();
 
-	auto cb = ai->cb.get();
 	auto mapSize = ai->cb->getMapSize();
 	
 	if(hitMap.shape()[0] != mapSize.x || hitMap.shape()[1] != mapSize.y || hitMap.shape()[2] != mapSize.z)
+	{
 		hitMap.resize(boost::extents[mapSize.x][mapSize.y][mapSize.z]);
-
-	enemyHeroAccessibleObjects.clear();
-	townThreats.clear();
+		heroThreats.clear();
+	}
 
 	std::map<PlayerColor, std::map<const CGHeroInstance *, HeroRole>> heroes;
 
@@ -98,16 +177,33 @@ void DangerHitMapAnalyzer::updateHitMap()
 		}
 	}
 
-	auto ourTowns = cb->getTownsInfo();
+	std::set<ObjectInstanceID> resetHeroes;
+	std::set<ObjectInstanceID> enemyHeroes;
+	std::vector<uint32_t> changedTiles;
+	int updatedHeroes = 0;
 
-	for(auto town : ourTowns)
 	{
-		townThreats[town->id]; // insert empty list
+		boost::lock_guard<boost::mutex> lock(outdatedHeroesMutex);
+
+		resetHeroes.swap(outdatedHeroes);
+
+		for(const int3 & tile : outdatedTiles)
+		{
+			if(tile.x >= 0 && tile.y >= 0 && tile.x < mapSize.x && tile.y < mapSize.y)
+				changedTiles.push_back(getTileIndex(tile, mapSize));
+		}
+
+		outdatedTiles.clear();
 	}
 
-	foreach_tile_pos([&](const int3 & pos){
-		hitMap[pos.x][pos.y][pos.z].reset();
-	});
+	// object changed on tile reached by enemy hero may have changed paths of this hero
+	auto reachesChangedTile = [&](const EnemyHeroThreats & threats) -> bool
+	{
+		return vstd::contains_if(changedTiles, [&](uint32_t tileIndex) -> bool
+			{
+				return threats.findTile(tileIndex) != nullptr;
+			});
+	};
 
 	for(auto pair : heroes)
 	{
@@ -117,79 +213,191 @@ void DangerHitMapAnalyzer::updateHitMap()
 		if(ai->cb->getPlayerRelations(ai->playerID, pair.first) != PlayerRelations::ENEMIES)
 			continue;
 
-		PathfinderSettings ps;
+		std::map<const CGHeroInstance *, HeroRole> changedHeroes;
+
+		for(auto & hero : pair.second)
+		{
+			auto cached = heroThreats.find(hero.first->id);
 
-		ps.scoutTurnDistanceLimit = ps.mainTurnDistanceLimit = ai->settings->getMainHeroTurnDistanceLimit();
-		ps.useHeroChain = false;
+			enemyHeroes.insert(hero.first->id);
 
-		ai->pathfinder->updatePaths(pair.second, ps);
+			if(cached == heroThreats.end()
+				|| vstd::contains(resetHeroes, hero.first->id)
+				|| cached->second.isOutdated(hero.first)
+				|| reachesChangedTile(cached->second))
+			{
+				changedHeroes.insert(hero);
+			}
+		}
+
+		if(!changedHeroes.empty())
+		{
+			updateHeroThreats(changedHeroes);
+			updatedHeroes += changedHeroes.size();
+		}
 
 		boost::this_thread::interruption_point();
+	}
 
-		pforeachTilePaths(mapSize, ai, [&](const int3 & pos, const std::vector<AIPath> & paths)
+	auto heroThreatsCount = heroThreats.size();
+
+	vstd::erase_if(heroThreats, [&](const std::pair<const ObjectInstanceID, EnemyHeroThreats> & item) -> bool
 		{
-			for(const AIPath & path : paths)
-			{
-				if(path.getFirstBlockedAction())
-					continue;
+			return !vstd::contains(enemyHeroes, item.first);
+		});
 
-				auto & node = hitMap[pos.x][pos.y][pos.z];
+	if(updatedHeroes || heroThreats.size() != heroThreatsCount)
+	{
+		version++;
+		heroThreatsMerged = false;
+	}
 
-				HitMapInfo newThreat;
+	if(!heroThreatsMerged)
+	{
+		mergeHeroThreats();
+		heroThreatsMerged = true;
+	}
 
-				newThreat.hero = path.targetHero;
-				newThreat.turn = path.turn();
-				newThreat.threat = path.getHeroStrength() * (1 - path.movementCost() / 2.0);
-				newThreat.danger = path.getHeroStrength();
+	logAi->trace("Danger hit map updated in %ld, threats of %d of %d heroes calculated", timeElapsed(start), updatedHeroes, enemyHeroes.size());
 
-				if(newThreat.value() > node.maximumDanger.value())
-				{
-					node.maximumDanger = newThreat;
-				}
+	logHitmap(ai->playerID, *this);
+}
 
-				if(newThreat.turn < node.fastestDanger.turn
-					|| (newThreat.turn == node.fastestDanger.turn && node.fastestDanger.danger < newThreat.danger))
-				{
-					node.fastestDanger = newThreat;
-				}
+void DangerHitMapAnalyzer::updateHeroThreats(const std::map<const CGHeroInstance *, HeroRole> & heroes)
+{
+	using TileThreats = tbb::concurrent_vector<EnemyHeroThreats::TileThreat>;
 
-				auto objects = cb->getVisitableObjs(pos, false);
+	auto mapSize = ai->cb->getMapSize();
+	std::map<const CGHeroInstance *, TileThreats> heroTiles;
+	PathfinderSettings ps;
+
+	ps.scoutTurnDistanceLimit = ps.mainTurnDistanceLimit = ai->settings->getMainHeroTurnDistanceLimit();
+	ps.useHeroChain = false;
+
+	ai->pathfinder->updatePaths(heroes, ps);
+
+	boost::this_thread::interruption_point();
+
+	for(auto & hero : heroes)
+	{
+		heroTiles[hero.first]; // insert empty list so threads only read the map
+	}
+
+	pforeachTilePaths(mapSize, ai, [&](const int3 & pos, const std::vector<AIPath> & paths)
+	{
+		boost::container::small_vector<std::pair<const CGHeroInstance *, HitMapNode>, 4> nodes;
+
+		for(const AIPath & path : paths)
+		{
+			if(path.getFirstBlockedAction())
+				continue;
 
-				for(auto obj : objects)
+			auto node = std::find_if(nodes.begin(), nodes.end(), [&](const std::pair<const CGHeroInstance *, HitMapNode> & n) -> bool
 				{
-					if(obj->ID == Obj::TOWN && obj->getOwner() == ai->playerID)
+					return n.first == path.targetHero;
+				});
+
+			if(node == nodes.end())
+			{
+				nodes.emplace_back(path.targetHero, HitMapNode());
+				node = std::prev(nodes.end());
+			}
+
+			HitMapInfo newThreat;
+
+			newThreat.hero = path.targetHero;
+			newThreat.turn = path.turn();
+			newThreat.threat = path.getHeroStrength() * (1 - path.movementCost() / 2.0);
+			newThreat.danger = path.getHeroStrength();
+
+			updateHitMapNode(node->second, newThreat, newThreat);
+		}
+
+		for(auto & node : nodes)
+		{
+			auto tiles = heroTiles.find(node.first);
+
+			if(tiles == heroTiles.end())
+				continue;
+
+			EnemyHeroThreats::TileThreat tile;
+
+			tile.tileIndex = getTileIndex(pos, mapSize);
+			tile.maximumDanger = node.second.maximumDanger.danger;
+			tile.maximumDangerTurn = node.second.maximumDanger.turn;
+			tile.maximumDangerThreat = node.second.maximumDanger.threat;
+			tile.fastestDanger = node.second.fastestDanger.danger;
+			tile.fastestDangerTurn = node.second.fastestDanger.turn;
+			tile.fastestDangerThreat = node.second.fastestDanger.threat;
+
+			tiles->second.push_back(tile);
+		}
+	});
+
+	for(auto & item : heroTiles)
+	{
+		EnemyHeroThreats threats(item.first);
+
+		threats.tiles.assign(item.second.begin(), item.second.end());
+		std::sort(threats.tiles.begin(), threats.tiles.end(), [](const EnemyHeroThreats::TileThreat & t1, const EnemyHeroThreats::TileThreat & t2) -> bool
+			{
+				return t1.tileIndex < t2.tileIndex;
+			});
+
+		heroThreats.insert_or_assign(item.first->id, std::move(threats));
+	}
+}
+
+void DangerHitMapAnalyzer::mergeHeroThreats()
+{
+	auto mapSize = ai->cb->getMapSize();
+	uint32_t tilesCount = mapSize.x * mapSize.y * mapSize.z;
+	HitMapNode * nodes = hitMap.data();
+
+	enemyHeroAccessibleObjects.clear();
+	townThreats.clear();
+
+	// each thread takes range of tiles and merges threats of all heroes to it so nodes are written without locking
+	tbb::parallel_for(tbb::blocked_range<uint32_t>(0, tilesCount), [&](const tbb::blocked_range<uint32_t> & r)
+		{
+			for(uint32_t i = r.begin(); i != r.end(); i++)
+			{
+				nodes[i].reset();
+			}
+
+			for(auto & item : heroThreats)
+			{
+				const EnemyHeroThreats & threats = item.second;
+				auto tile = std::lower_bound(threats.tiles.begin(), threats.tiles.end(), r.begin(), [](const EnemyHeroThreats::TileThreat & t, uint32_t index) -> bool
 					{
-						auto & threats = townThreats[obj->id];
-						auto threat = std::find_if(threats.begin(), threats.end(), [&](const HitMapInfo & i) -> bool
-							{
-								return i.hero.hid == path.targetHero->id;
-							});
-
-						if(threat == threats.end())
-						{
-							threats.emplace_back();
-							threat = std::prev(threats.end(), 1);
-						}
-
-						if(newThreat.value() > threat->value())
-						{
-							*threat = newThreat;
-						}
-
-						if(newThreat.turn == 0)
-						{
-							if(cb->getPlayerRelations(obj->tempOwner, ai->playerID) != PlayerRelations::ENEMIES)
-								enemyHeroAccessibleObjects.emplace_back(path.targetHero, obj);
-						}
-					}
+						return t.tileIndex < index;
+					});
+
+				for(; tile != threats.tiles.end() && tile->tileIndex < r.end(); tile++)
+				{
+					updateHitMapNode(nodes[tile->tileIndex], threats.getMaximumDanger(*tile), threats.getFastestDanger(*tile));
 				}
 			}
 		});
-	}
 
-	logAi->trace("Danger hit map updated in %ld", timeElapsed(start));
+	for(auto town : ai->cb->getTownsInfo())
+	{
+		auto & threats = townThreats[town->id];
+		uint32_t townTile = getTileIndex(town->visitablePos(), mapSize);
 
-	logHitmap(ai->playerID, *this);
+		for(auto & item : heroThreats)
+		{
+			auto tile = item.second.findTile(townTile);
+
+			if(!tile)
+				continue;
+
+			threats.push_back(item.second.getMaximumDanger(*tile));
+
+			if(tile->fastestDangerTurn == 0)
+				enemyHeroAccessibleObjects.emplace_back(item.second.hero.get(true), town);
+		}
+	}
 }
 
 void DangerHitMapAnalyzer::calculateTileOwners()
@@ -347,6 +555,36 @@ std::set<const CGObjectInstance *> DangerHitMapAnalyzer::getOneTurnAccessibleObj
 
 void DangerHitMapAnalyzer::reset()
 {
+	heroThreatsMerged = false;
+	hitMapUpToDate = false;
+}
+
+void DangerHitMapAnalyzer::resetHero(ObjectInstanceID heroId)
+{
+	boost::lock_guard<boost::mutex> lock(outdatedHeroesMutex);
+
+	outdatedHeroes.insert(heroId);
+	hitMapUpToDate = false;
+}
+
+void DangerHitMapAnalyzer::resetObject(const CGObjectInstance * obj)
+{
+	std::set<int3> objectTiles = obj->getBlockedPos();
+
+	objectTiles.insert(obj->visitablePos());
+
+	boost::lock_guard<boost::mutex> lock(outdatedHeroesMutex);
+
+	// neighbour tiles are included since object may guard them
+	for(const int3 & tile : objectTiles)
+	{
+		for(int dx = -1; dx <= 1; dx++)
+		{
+			for(int dy = -1; dy <= 1; dy++)
+				outdatedTiles.push_back(tile + int3(dx, dy, 0));
+		}
+	}
+
 	hitMapUpToDate = false;
 }
 
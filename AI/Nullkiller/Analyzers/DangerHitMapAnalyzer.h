@@ -68,6 +68,40 @@ struct EnemyHeroAccessibleObject
 	}
 };
 
+/// Threats of one enemy hero to tiles it can reach. Kept between hit map updates and calculated again only
+/// when the hero moves or its army, mana or movement changes
+struct EnemyHeroThreats
+{
+	struct TileThreat
+	{
+		uint32_t tileIndex;
+		uint8_t maximumDangerTurn;
+		uint8_t fastestDangerTurn;
+		float maximumDangerThreat;
+		float fastestDangerThreat;
+		uint64_t maximumDanger;
+		uint64_t fastestDanger;
+	};
+
+	HeroPtr hero;
+	PlayerColor owner;
+	int3 position;
+	uint64_t strength;
+	int mana;
+	int movement;
+	bool inBoat;
+
+	/// Sorted by tile index
+	std::vector<TileThreat> tiles;
+
+	EnemyHeroThreats(const CGHeroInstance * hero);
+
+	bool isOutdated(const CGHeroInstance * hero) const;
+	const TileThreat * findTile(uint32_t tileIndex) const;
+	HitMapInfo getMaximumDanger(const TileThreat & tile) const;
+	HitMapInfo getFastestDanger(const TileThreat & tile) const;
+};
+
 class DangerHitMapAnalyzer
 {
 private:
@@ -75,8 +109,17 @@ private:
 	tbb::concurrent_vector<EnemyHeroAccessibleObject> enemyHeroAccessibleObjects;
 	bool hitMapUpToDate = false;
 	bool tileOwnersUpToDate = false;
+	uint32_t version = 0;
 	const Nullkiller * ai;
 	std::map<ObjectInstanceID, std::vector<HitMapInfo>> townThreats;
+	std::map<ObjectInstanceID, EnemyHeroThreats> heroThreats;
+	std::set<ObjectInstanceID> outdatedHeroes;
+	std::vector<int3> outdatedTiles;
+	bool heroThreatsMerged = false;
+	boost::mutex outdatedHeroesMutex;
+
+	void updateHeroThreats(const std::map<const CGHeroInstance *, HeroRole> & heroes);
+	void mergeHeroThreats();
 
 public:
 	DangerHitMapAnalyzer(const Nullkiller * ai) :ai(ai) {}
@@ -87,8 +130,15 @@ public:
 	const HitMapNode & getObjectThreat(const CGObjectInstance * obj) const;
 	const HitMapNode & getTileThreat(const int3 & tile) const;
 	std::set<const CGObjectInstance *> getOneTurnAccessibleObjects(const CGHeroInstance * enemy) const;
+	/// Called at turn start, when enemy hero appears or disappears and on gaining a town, cached threats are merged again on next update
 	void reset();
+	/// Called on events changing the hero, only threats of this hero are calculated again on next update
+	void resetHero(ObjectInstanceID heroId);
+	/// Called when object appears, is removed or changes owner, threats of heroes reaching its tiles are calculated again on next update
+	void resetObject(const CGObjectInstance * obj);
 	void resetTileOwners() { tileOwnersUpToDate = false; }
+	/// Increased when threats of any enemy hero changed during hit map update
+	uint32_t getVersion() const { return version; }
 	PlayerColor getTileOwner(const int3 & tile) const;
 	const CGTownInstance * getClosestTown(const int3 & tile) const;
 	const std::vector<HitMapInfo> & getTownThreats(const CGTownInstance * town) const;
@@ -27,14 +27,23 @@ namespace NKAI
 using namespace Goals;
 
 DeepDecomposer::DeepDecomposer(const Nullkiller * ai)
-	:ai(ai), depth(0)
+	:ai(ai), depth(0), cachedPathsGeneration(0), cachedStateVersion(0)
 {
 }
 
 void DeepDecomposer::reset()
 {
-	decompositionCache.clear();
 	goals.clear();
+
+	auto pathsGeneration = ai->pathfinder->getGeneration();
+	auto stateVersion = ai->evaluationCache->getStateVersion();
+
+	if(pathsGeneration == cachedPathsGeneration && stateVersion == cachedStateVersion)
+		return;
+
+	decompositionCache.clear();
+	cachedPathsGeneration = pathsGeneration;
+	cachedStateVersion = stateVersion;
 }
 
 void DeepDecomposer::decompose(TGoalVec & result, TSubgoal behavior, int depthLimit)
@@ -31,9 +31,12 @@ private:
 	std::vector<TGoalHashSet> decompositionCache;
 	int depth;
 	const Nullkiller * ai;
+	uint32_t cachedPathsGeneration;
+	uint32_t cachedStateVersion;
 
 public:
 	DeepDecomposer(const Nullkiller * ai);
+	/// Decomposed goals hold paths so the cache is kept between passes only while paths and shared state did not change
 	void reset();
 	void decompose(Goals::TGoalVec & result, Goals::TSubgoal behavior, int depthLimit);
 
@@ -23,6 +23,7 @@
 #include "../Goals/Invalid.h"
 #include "../Goals/Composition.h"
 #include "../../../lib/CPlayerState.h"
+#include "../../../lib/PerformanceStatistics.h"
 #include "../../lib/StartInfo.h"
 
 namespace NKAI
@@ -30,9 +31,6 @@ namespace NKAI
 
 using namespace Goals;
 
-// while we play vcmieagles graph can be shared
-std::unique_ptr<ObjectGraph> Nullkiller::baseGraph;
-
 Nullkiller::Nullkiller()
 	:activeHero(nullptr), scanDepth(ScanDepth::MAIN_FULL), useHeroChain(true)
 {
@@ -65,6 +63,29 @@ bool canUseOpenMap(std::shared_ptr<CCallback> cb, PlayerColor playerID)
 	return cb->getStartInfo()->difficulty >= 3;
 }
 
+int getThreadsCount(std::shared_ptr<CCallback> cb, int threadsPerPlayer)
+{
+	if(threadsPerPlayer > 0)
+		return threadsPerPlayer;
+
+	int threads = std::max<int>(1, boost::thread::hardware_concurrency());
+	const auto & simturns = cb->getStartInfo()->simturnsInfo;
+
+	if(simturns.requiredTurns == 0 && simturns.optionalTurns == 0)
+		return threads;
+
+	// during simultaneous turns all AI players may plan at the same time
+	int aiPlayers = 0;
+
+	for(const auto & player : cb->getStartInfo()->playerInfos)
+	{
+		if(player.second.isControlledByAI())
+			aiPlayers++;
+	}
+
+	return std::max(1, threads / std::max(1, aiPlayers));
+}
+
 void Nullkiller::init(std::shared_ptr<CCallback> cb, AIGateway * gateway)
 {
 	this->cb = cb;
@@ -79,6 +100,7 @@ void Nullkiller::init(std::shared_ptr<CCallback> cb, AIGateway * gateway)
 	}
 
 	baseGraph.reset();
+	arena = std::make_unique<tbb::task_arena>(getThreadsCount(cb, settings->getThreadsPerPlayer()));
 
 	priorityEvaluator.reset(new PriorityEvaluator(this));
 	priorityEvaluators.reset(
@@ -88,6 +110,7 @@ void Nullkiller::init(std::shared_ptr<CCallback> cb, AIGateway * gateway)
 				return std::make_unique<PriorityEvaluator>(this);
 			}));
 
+	evaluationCache.reset(new EvaluationContextCache(this));
 	dangerHitMap.reset(new DangerHitMapAnalyzer(this));
 	buildAnalyzer.reset(new BuildAnalyzer(this));
 	objectClusterizer.reset(new ObjectClusterizer(this));
@@ -171,6 +194,7 @@ Goals::TTask Nullkiller::choseBestTask(Goals::TGoalVec & tasks) const
 
 Goals::TTaskVec Nullkiller::buildPlan(TGoalVec & tasks, int priorityTier) const
 {
+	PerformanceTimer timer("Nullkiller::buildPlan");
 	TaskPlan taskPlan;
 
 	tbb::parallel_for(tbb::blocked_range<size_t>(0, tasks.size()), [this, &tasks, priorityTier](const tbb::blocked_range<size_t> & r)
@@ -226,11 +250,20 @@ void Nullkiller::resetAiState()
 	dangerHitMap->reset();
 	useHeroChain = true;
 	objectClusterizer->reset();
+	evaluationCache->reset();
 
-	if(!baseGraph && isObjectGraphAllowed())
+	if(isObjectGraphAllowed())
 	{
-		baseGraph = std::make_unique<ObjectGraph>();
-		baseGraph->updateGraph(this);
+		// graph is kept between turns, only objects which appeared since last turn are connected to it
+		if(!baseGraph)
+		{
+			baseGraph = std::make_unique<ObjectGraph>(cb->getMapSize());
+			baseGraph->updateGraph(this);
+		}
+		else
+		{
+			baseGraph->addNewObjects(this);
+		}
 	}
 }
 
@@ -238,6 +271,8 @@ void Nullkiller::updateAiState(int pass, bool fast)
 {
 	boost::this_thread::interruption_point();
 
+	PerformanceTimer timer("Nullkiller::updateAiState");
+
 	std::unique_lock lockGuard(aiStateMutex);
 
 	auto start = std::chrono::high_resolution_clock::now();
@@ -245,7 +280,6 @@ void Nullkiller::updateAiState(int pass, bool fast)
 	activeHero = nullptr;
 	setTargetObject(-1);
 
-	decomposer->reset();
 	buildAnalyzer->update();
 
 	if(!fast)
@@ -298,10 +332,17 @@ void Nullkiller::updateAiState(int pass, bool fast)
 
 		boost::this_thread::interruption_point();
 
+		// clusterizer already evaluates tasks so the cache has to know new state before it
+		evaluationCache->update();
 		objectClusterizer->clusterize();
 	}
+	else
+	{
+		evaluationCache->update();
+	}
 
 	armyManager->update();
+	decomposer->reset();
 
 	logAi->debug("AI state updated in %ld", timeElapsed(start));
 }
@@ -346,9 +387,18 @@ HeroLockedReason Nullkiller::getHeroLockedReason(const CGHeroInstance * hero) co
 
 void Nullkiller::makeTurn()
 {
-	boost::lock_guard<boost::mutex> sharedStorageLock(AISharedStorage::locker);
+	arena->execute([this]()
+	{
+		executeTurn();
+	});
+}
+
+void Nullkiller::executeTurn()
+{
+	PerformanceTimer timer("Nullkiller::makeTurn");
 
 	const int MAX_DEPTH = 10;
+	const auto bonusCacheStatsAtStart = CBonusSystemNode::getCacheStatistics();
 
 	resetAiState();
 
@@ -430,6 +480,11 @@ void Nullkiller::makeTurn()
 
 		logAi->debug("Decision madel in %ld", timeElapsed(start));
 
+		auto bonusCacheStats = CBonusSystemNode::getCacheStatistics();
+		logAi->debug("Bonus cache since turn start: %d hits, %d rebuilds",
+			bonusCacheStats.first - bonusCacheStatsAtStart.first,
+			bonusCacheStats.second - bonusCacheStatsAtStart.second);
+
 		if(selectedTasks.empty())
 		{
 			selectedTasks.push_back(taskptr(Goals::Invalid()));
@@ -559,6 +614,7 @@ HeroRole Nullkiller::getTaskRole(Goals::TTask task) const
 
 bool Nullkiller::executeTask(Goals::TTask task)
 {
+	PerformanceTimer timer("Nullkiller::executeTask");
 	auto start = std::chrono::high_resolution_clock::now();
 	std::string taskDescr = task->toString();
 
@@ -78,15 +78,18 @@ private:
 	AIGateway * gateway;
 	bool openMap;
 	bool useObjectGraph;
+	/// Threads used by this AI player. Several AI players may make turn at the same time so each has own share of cores
+	std::unique_ptr<tbb::task_arena> arena;
 
 public:
-	static std::unique_ptr<ObjectGraph> baseGraph;
+	std::unique_ptr<ObjectGraph> baseGraph;
 
 	std::unique_ptr<DangerHitMapAnalyzer> dangerHitMap;
 	std::unique_ptr<BuildAnalyzer> buildAnalyzer;
 	std::unique_ptr<ObjectClusterizer> objectClusterizer;
 	std::unique_ptr<PriorityEvaluator> priorityEvaluator;
 	std::unique_ptr<SharedPool<PriorityEvaluator>> priorityEvaluators;
+	std::unique_ptr<EvaluationContextCache> evaluationCache;
 	std::unique_ptr<AIPathfinder> pathfinder;
 	std::unique_ptr<HeroManager> heroManager;
 	std::unique_ptr<ArmyManager> armyManager;
@@ -123,6 +126,7 @@ public:
 	bool handleTrading();
 
 private:
+	void executeTurn();
 	void resetAiState();
 	void updateAiState(int pass, bool fast = false);
 	void decompose(Goals::TGoalVec & result, Goals::TSubgoal behavior, int decompositionMaxDepth) const;
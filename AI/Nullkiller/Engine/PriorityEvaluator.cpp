@@ -1257,6 +1257,213 @@ uint64_t RewardEvaluator::getUpgradeArmyReward(const CGTownInstance * town, cons
 	return upgradedPower - creaturesToUpgrade.power;
 }
 
+void EvaluationContextKey::add(const int3 & tile)
+{
+	add(tile.x);
+	add(tile.y);
+	add(tile.z);
+}
+
+void EvaluationContextKey::add(const TResources & resources)
+{
+	for(int i = 0; i < GameConstants::RESOURCE_QUANTITY; i++)
+	{
+		add(resources[i]);
+	}
+}
+
+void EvaluationContextKey::add(const EvaluationContextKey & other)
+{
+	values.insert(values.end(), other.values.begin(), other.values.end());
+}
+
+std::size_t EvaluationContextKey::getHash() const
+{
+	std::size_t hash = values.size();
+
+	for(auto value : values)
+	{
+		vstd::hash_combine(hash, value);
+	}
+
+	return hash;
+}
+
+EvaluationContextCache::EvaluationContextCache(const Nullkiller * ai)
+	:ai(ai), stateVersion(0), hits(0), misses(0)
+{
+}
+
+void EvaluationContextCache::reset()
+{
+	contexts.clear();
+	heroStates.clear();
+	state = EvaluationContextKey();
+	stateVersion++;
+}
+
+void EvaluationContextCache::update()
+{
+	EvaluationContextKey newState;
+
+	newState.add(ai->cb->getResourceAmount());
+	newState.add(ai->buildAnalyzer->getResourcesRequiredNow());
+	newState.add(ai->buildAnalyzer->getTotalResourcesRequired());
+	newState.add(ai->buildAnalyzer->getDailyIncome());
+	newState.add(ai->buildAnalyzer->getDevelopmentInfo().size());
+	newState.add(ai->cb->getTownsInfo().size());
+	newState.add(ai->cb->getDate(Date::DAY));
+	newState.add(ai->dangerHitMap->getVersion());
+
+	logAi->debug("Evaluation cache: %d hits, %d misses, %d contexts", hits.load(), misses.load(), contexts.size());
+
+	if(newState != state)
+	{
+		contexts.clear();
+		state = std::move(newState);
+		stateVersion++;
+	}
+
+	hits = 0;
+	misses = 0;
+	heroStates.clear();
+
+	for(auto hero : ai->cb->getHeroesInfo())
+	{
+		EvaluationContextKey heroState;
+
+		addObjectState(heroState, hero);
+		heroState.add(hero->movementPointsRemaining());
+		heroState.add(hero->mana);
+		heroState.add(hero->exp);
+		heroState.add(hero->secSkills.size());
+		heroState.add(hero->getHeroStrength());
+		heroState.add(ai->heroManager->getHeroRole(hero));
+
+		heroStates[hero] = std::move(heroState);
+	}
+}
+
+void EvaluationContextCache::addObjectState(EvaluationContextKey & key, const CGObjectInstance * obj) const
+{
+	key.add(obj->id.getNum());
+	key.add(obj->tempOwner.getNum());
+	key.add(obj->visitablePos());
+	key.add(ai->memory->wasVisited(obj));
+
+	auto armed = dynamic_cast<const CArmedInstance *>(obj);
+
+	key.add(armed ? armed->getArmyStrength() : 0);
+}
+
+bool EvaluationContextCache::addPath(EvaluationContextKey & key, const AIPath & path) const
+{
+	auto heroState = heroStates.find(path.targetHero);
+
+	if(heroState == heroStates.end())
+		return false;
+
+	key.add(heroState->second);
+	key.add(path.nodes.size());
+
+	for(auto & node : path.nodes)
+	{
+		heroState = heroStates.find(node.targetHero);
+
+		if(heroState == heroStates.end())
+			return false;
+
+		key.add(heroState->second);
+		key.add(node.coord);
+		key.add(node.cost);
+		key.add(node.turns);
+		key.add(node.danger);
+		key.add(node.chainMask);
+		key.add(node.layer.getNum());
+	}
+
+	key.add(path.targetObjectDanger);
+	key.add(path.armyLoss);
+	key.add(path.targetObjectArmyLoss);
+	key.add(path.chainMask);
+	key.add(path.exchangeCount);
+	key.add(path.heroArmy->getArmyStrength());
+
+	return true;
+}
+
+bool EvaluationContextCache::getTaskKey(Goals::TSubgoal task, EvaluationContextKey & key) const
+{
+	Goals::TGoalVec parts = task->goalType == Goals::COMPOSITION ? task->decompose(ai) : Goals::TGoalVec{task};
+
+	key.add(parts.size());
+
+	for(auto part : parts)
+	{
+		key.add(part->goalType);
+		key.add(part->goldCost);
+		key.add(part->buildingCost);
+
+		switch(part->goalType)
+		{
+		case Goals::EXECUTE_HERO_CHAIN:
+		{
+			auto & chain = dynamic_cast<const Goals::ExecuteHeroChain &>(*part);
+			auto target = ai->cb->getObj(ObjectInstanceID(part->objid), false);
+
+			if(!addPath(key, chain.getPath()))
+				return false;
+
+			key.add(chain.closestWayRatio);
+			key.add(target != nullptr);
+
+			if(target)
+				addObjectState(key, target);
+			break;
+		}
+		// these evaluators read state of town, cluster or hero exchange which is not tracked
+		case Goals::BUILD_STRUCTURE:
+		case Goals::UNLOCK_CLUSTER:
+		case Goals::HERO_EXCHANGE:
+		case Goals::ARMY_UPGRADE:
+		case Goals::DEFEND_TOWN:
+		case Goals::EXCHANGE_SWAP_TOWN_HEROES:
+		case Goals::DISMISS_HERO:
+		case Goals::STAY_AT_TOWN:
+			return false;
+		default:
+			key.add(part->objid);
+			key.add(part->tile);
+			key.add(part->value);
+			break;
+		}
+	}
+
+	return true;
+}
+
+bool EvaluationContextCache::tryGetContext(const EvaluationContextKey & key, EvaluationContext & context) const
+{
+	decltype(contexts)::const_accessor cached;
+
+	if(!contexts.find(cached, key))
+	{
+		misses++;
+
+		return false;
+	}
+
+	hits++;
+	context = cached->second;
+
+	return true;
+}
+
+void EvaluationContextCache::addContext(const EvaluationContextKey & key, const EvaluationContext & context)
+{
+	contexts.insert(std::make_pair(key, context));
+}
+
 PriorityEvaluator::PriorityEvaluator(const Nullkiller * ai)
 	:ai(ai)
 {
@@ -1277,6 +1484,11 @@ EvaluationContext PriorityEvaluator::buildEvaluationContext(Goals::TSubgoal goal
 {
 	Goals::TGoalVec parts;
 	EvaluationContext context(ai);
+	EvaluationContextKey taskKey;
+	bool cacheable = ai->evaluationCache->getTaskKey(goal, taskKey);
+
+	if(cacheable && ai->evaluationCache->tryGetContext(taskKey, context))
+		return context;
 
 	if(goal->goalType == Goals::COMPOSITION)
 	{
@@ -1298,6 +1510,9 @@ EvaluationContext PriorityEvaluator::buildEvaluationContext(Goals::TSubgoal goal
 		}
 	}
 
+	if(cacheable)
+		ai->evaluationCache->addContext(taskKey, context);
+
 	return context;
 }
 
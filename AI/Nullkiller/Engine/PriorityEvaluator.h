@@ -90,6 +90,77 @@ struct DLL_EXPORT EvaluationContext
 	void addNonCriticalStrategicalValue(float value);
 };
 
+/// Exact description of an evaluated task together with the state it depends on.
+/// Keys are compared value by value, so different tasks never share a context even if their hashes collide
+class EvaluationContextKey
+{
+private:
+	std::vector<int64_t> values;
+
+public:
+	template<typename T>
+	void add(const T & value)
+	{
+		if constexpr(std::is_floating_point_v<T>)
+		{
+			double exact = value;
+			int64_t bits;
+
+			std::memcpy(&bits, &exact, sizeof(bits));
+			values.push_back(bits);
+		}
+		else
+		{
+			values.push_back(static_cast<int64_t>(value));
+		}
+	}
+
+	void add(const int3 & tile);
+	void add(const TResources & resources);
+	void add(const EvaluationContextKey & other);
+
+	std::size_t getHash() const;
+	bool operator==(const EvaluationContextKey & other) const { return values == other.values; }
+	bool operator!=(const EvaluationContextKey & other) const { return values != other.values; }
+};
+
+struct EvaluationContextKeyHashCompare
+{
+	static std::size_t hash(const EvaluationContextKey & key) { return key.getHash(); }
+	static bool equal(const EvaluationContextKey & a, const EvaluationContextKey & b) { return a == b; }
+};
+
+/// Evaluation contexts of tasks kept between passes of one turn. Usually most of tasks are same after single hero action
+/// so their contexts are reused until the task itself or the state it was evaluated against changes.
+class EvaluationContextCache
+{
+private:
+	const Nullkiller * ai;
+	EvaluationContextKey state;
+	uint32_t stateVersion;
+	std::map<const CGHeroInstance *, EvaluationContextKey> heroStates;
+	tbb::concurrent_hash_map<EvaluationContextKey, EvaluationContext, EvaluationContextKeyHashCompare> contexts;
+	mutable std::atomic<uint32_t> hits;
+	mutable std::atomic<uint32_t> misses;
+
+	void addObjectState(EvaluationContextKey & key, const CGObjectInstance * obj) const;
+	bool addPath(EvaluationContextKey & key, const AIPath & path) const;
+
+public:
+	EvaluationContextCache(const Nullkiller * ai);
+
+	/// Called after ai state update, drops all contexts if resources, danger or other shared state changed
+	void update();
+	void reset();
+	/// Increased every time cached contexts are dropped because of shared state change
+	uint32_t getStateVersion() const { return stateVersion; }
+
+	/// Returns false if task depends on something which is not tracked by the cache
+	bool getTaskKey(Goals::TSubgoal task, EvaluationContextKey & key) const;
+	bool tryGetContext(const EvaluationContextKey & key, EvaluationContext & context) const;
+	void addContext(const EvaluationContextKey & key, const EvaluationContext & context);
+};
+
 class IEvaluationContextBuilder
 {
 public:
@@ -31,7 +31,9 @@ namespace NKAI
 		allowObjectGraph(true),
 		useTroopsFromGarrisons(false),
 		openMap(true),
-		useFuzzy(false)
+		useFuzzy(false),
+		pathfinderMemoryLimit(0),
+		threadsPerPlayer(0)
 	{
 		JsonNode node = JsonUtils::assembleFromFiles("config/ai/nkai/nkai-settings");
 
@@ -75,6 +77,16 @@ namespace NKAI
 			useFuzzy = node.Struct()["useFuzzy"].Bool();
 		}
 
+		if(node.Struct()["pathfinderMemoryLimit"].isNumber())
+		{
+			pathfinderMemoryLimit = node.Struct()["pathfinderMemoryLimit"].Integer();
+		}
+
+		if(node.Struct()["threadsPerPlayer"].isNumber())
+		{
+			threadsPerPlayer = node.Struct()["threadsPerPlayer"].Integer();
+		}
+
 		if(!node.Struct()["useTroopsFromGarrisons"].isNull())
 		{
 			useTroopsFromGarrisons = node.Struct()["useTroopsFromGarrisons"].Bool();
@@ -30,6 +30,8 @@ namespace NKAI
 		bool useTroopsFromGarrisons;
 		bool openMap;
 		bool useFuzzy;
+		int pathfinderMemoryLimit;
+		int threadsPerPlayer;
 
 	public:
 		Settings();
@@ -43,5 +45,10 @@ namespace NKAI
 		bool isGarrisonTroopsUsageAllowed() const { return useTroopsFromGarrisons; }
 		bool isOpenMap() const { return openMap; }
 		bool isUseFuzzy() const { return useFuzzy; }
+		/// Limit of memory used by additional hero chain nodes of all AI players together in bytes, 0 - unlimited
+		/// First chain nodes of every reached tile are not limited so distant tiles remain reachable
+		size_t getPathfinderMemoryLimit() const { return static_cast<size_t>(pathfinderMemoryLimit) * 1024 * 1024; }
+		/// Number of threads used by one AI player, 0 - share all cores between AI players during simultaneous turns
+		int getThreadsPerPlayer() const { return threadsPerPlayer; }
 	};
 }
@@ -21,16 +21,12 @@
 #include "../../../lib/pathfinder/PathfinderUtil.h"
 #include "../../../lib/pathfinder/PathfinderOptions.h"
 #include "../../../lib/CPlayerState.h"
+#include "../../../lib/StartInfo.h"
 
 namespace NKAI
 {
 
-std::shared_ptr<boost::multi_array<AIPathNode, 4>> AISharedStorage::shared;
-uint32_t AISharedStorage::version = 0;
-boost::mutex AISharedStorage::locker;
-std::set<int3> committedTiles;
-std::set<int3> committedTilesInitial;
-
+const std::shared_ptr<const SpecialAction> SpecialActionRef::empty;
 
 const uint64_t FirstActorMask = 1;
 const uint64_t MIN_ARMY_STRENGTH_FOR_CHAIN = 5000;
@@ -39,64 +35,226 @@ const uint64_t CHAIN_MAX_DEPTH = 4;
 
 const bool DO_NOT_SAVE_TO_COMMITTED_TILES = false;
 
-AISharedStorage::AISharedStorage(int3 sizes)
+AIAccessibilityGrid::AIAccessibilityGrid(const int3 & sizes)
+	: tiles(boost::extents[sizes.z][sizes.x][sizes.y][EPathfindingLayer::NUM_LAYERS]),
+	initialized(false),
+	useFlying(false),
+	useWaterWalking(false)
 {
-	if(!shared){
-		shared.reset(new boost::multi_array<AIPathNode, 4>(
-			boost::extents[sizes.z][sizes.x][sizes.y][AIPathfinding::NUM_CHAINS]));
+}
 
-		nodes = shared;
+AIChainPool::AIChainPool(const int3 & sizes, size_t memoryLimit)
+	: tiles(boost::extents[sizes.z][sizes.x][sizes.y]), allocatedChunks(0), extraChunks(0), exhaustionLogged(false)
+{
+	size_t tileCount = static_cast<size_t>(sizes.x) * sizes.y * sizes.z;
+	size_t chunkSize = sizeof(AIPathNode) * AIPathfinding::CHAIN_CHUNK_SIZE;
 
-		foreach_tile_pos([&](const int3 & pos)
-			{
-				for(auto i = 0; i < AIPathfinding::NUM_CHAINS; i++)
-				{
-					auto & node = get(pos)[i];
-						
-					node.version = -1;
-					node.coord = pos;
-				}
-			});
+	maxExtraChunks = tileCount * (AIPathfinding::MAX_CHAIN_CHUNKS - 1);
+
+	if(memoryLimit)
+		vstd::amin(maxExtraChunks, memoryLimit / chunkSize);
+
+	blocks = std::vector<std::atomic<AIPathNode *>>((tileCount + maxExtraChunks + CHUNKS_PER_BLOCK - 1) / CHUNKS_PER_BLOCK);
+
+	AITileChains emptyTile;
+
+	emptyTile.version = -1;
+	emptyTile.chunksCount = 0;
+
+	std::fill_n(tiles.data(), tiles.num_elements(), emptyTile);
+}
+
+AIChainPool::~AIChainPool()
+{
+	for(auto & block : blocks)
+		delete[] block.load();
+}
+
+void AIChainPool::clear()
+{
+	allocatedChunks = 0;
+	extraChunks = 0;
+	exhaustionLogged = false;
+
+	boost::lock_guard<boost::mutex> lock(actionsLock);
+
+	actions.clear();
+}
+
+AITileChains & AIChainPool::getTile(const int3 & tile, uint32_t version)
+{
+	AITileChains & chains = tiles[tile.z][tile.x][tile.y];
+
+	if(chains.version != version)
+	{
+		chains.version = version;
+		chains.chunksCount = 0;
 	}
-	else
-		nodes = shared;
+
+	return chains;
+}
+
+const AITileChains * AIChainPool::findTile(const int3 & tile, uint32_t version) const
+{
+	const AITileChains & chains = tiles[tile.z][tile.x][tile.y];
+
+	return chains.version == version ? &chains : nullptr;
 }
 
-AISharedStorage::~AISharedStorage()
+AIPathNode * AIChainPool::getBlock(size_t blockIndex)
 {
-	nodes.reset();
-	if(shared && shared.use_count() == 1)
+	AIPathNode * block = blocks[blockIndex].load();
+
+	if(block)
+		return block;
+
+	boost::lock_guard<boost::mutex> lock(blocksLock);
+
+	block = blocks[blockIndex].load();
+
+	if(!block)
 	{
-		shared.reset();
+		block = new AIPathNode[CHUNKS_PER_BLOCK * AIPathfinding::CHAIN_CHUNK_SIZE];
+		blocks[blockIndex] = block;
 	}
+
+	return block;
+}
+
+bool AIChainPool::reserveExtraChunk(uint8_t chunksCount)
+{
+	// each next chunk of the tile is allowed to use smaller part of the limit
+	// so when memory is short all reached tiles still get few chains
+	size_t chunkLimit = maxExtraChunks * (AIPathfinding::MAX_CHAIN_CHUNKS - chunksCount) / (AIPathfinding::MAX_CHAIN_CHUNKS - 1);
+	size_t reserved = extraChunks.load();
+
+	do
+	{
+		if(reserved >= chunkLimit)
+		{
+			if(!exhaustionLogged.exchange(true))
+				logAi->debug("Chain pool reached memory limit, further tiles get fewer chains until next pathfinder run");
+
+			return false;
+		}
+	} while(!extraChunks.compare_exchange_weak(reserved, reserved + 1));
+
+	return true;
 }
 
-void AIPathNode::addSpecialAction(std::shared_ptr<const SpecialAction> action)
+AIPathNode * AIChainPool::allocateChunk(AITileChains & tile, const int3 & pos)
 {
-	if(!specialAction)
+	// hero chain tasks may extend the same tile from several threads, tiles share few locks
+	auto tileIndex = static_cast<size_t>(&tile - tiles.data());
+	boost::lock_guard<boost::mutex> lock(tileLocks[tileIndex % TILE_LOCK_COUNT]);
+
+	if(tile.chunksCount >= AIPathfinding::MAX_CHAIN_CHUNKS)
+		return nullptr;
+
+	// first chunk is not limited, pool has room for one chunk of every tile besides the limit
+	if(tile.chunksCount && !reserveExtraChunk(tile.chunksCount))
+		return nullptr;
+
+	size_t chunkIndex = allocatedChunks.fetch_add(1);
+	AIPathNode * chunk = getBlock(chunkIndex / CHUNKS_PER_BLOCK) + (chunkIndex % CHUNKS_PER_BLOCK) * AIPathfinding::CHAIN_CHUNK_SIZE;
+
+	for(int i = 0; i < AIPathfinding::CHAIN_CHUNK_SIZE; i++)
 	{
-		specialAction = action;
+		chunk[i].version = -1;
+		chunk[i].coord = pos;
+	}
+
+	tile.chunks[tile.chunksCount++] = chunk;
+
+	return chunk;
+}
+
+SpecialActionRef AIChainPool::retainAction(std::shared_ptr<const SpecialAction> action)
+{
+	if(!action)
+		return SpecialActionRef();
+
+	boost::lock_guard<boost::mutex> lock(actionsLock);
+
+	// map nodes are never moved so node may keep pointer to stored shared pointer
+	auto inserted = actions.try_emplace(action.get(), action);
+
+	return SpecialActionRef(inserted.first->second);
+}
+
+size_t AIChainPool::getMemoryUsage() const
+{
+	size_t result = tiles.num_elements() * sizeof(AITileChains);
+
+	for(auto & block : blocks)
+	{
+		if(block.load())
+			result += CHUNKS_PER_BLOCK * AIPathfinding::CHAIN_CHUNK_SIZE * sizeof(AIPathNode);
+	}
+
+	return result;
+}
+
+AISharedStorage::AISharedStorage(int3 sizes, size_t memoryLimit)
+	: nodes(std::make_unique<AIChainPool>(sizes, memoryLimit)), version(0)
+{
+}
+
+AISharedStorage::~AISharedStorage() = default;
+
+void AISharedStorage::nextVersion()
+{
+	version++;
+	nodes->clear();
+}
+
+void AINodeStorage::setSpecialAction(AIPathNode * node, std::shared_ptr<const SpecialAction> action)
+{
+	node->specialAction = nodes.retainAction(action);
+}
+
+void AINodeStorage::addSpecialAction(AIPathNode * node, std::shared_ptr<const SpecialAction> action)
+{
+	if(!node->specialAction)
+	{
+		setSpecialAction(node, action);
 	}
 	else
 	{
-		auto parts = specialAction->getParts();
+		auto parts = node->specialAction->getParts();
 
 		if(parts.empty())
 		{
-			parts.push_back(specialAction);
+			parts.push_back(node->specialAction);
 		}
 
 		parts.push_back(action);
 
-		specialAction = std::make_shared<CompositeAction>(parts);
+		setSpecialAction(node, std::make_shared<CompositeAction>(parts));
 	}
 }
 
+static size_t getPlayerMemoryLimit(const CPlayerSpecificInfoCallback * cb, size_t totalLimit)
+{
+	// every AI player keeps its own pool for whole game, so limit is shared between all of them
+	int aiPlayers = 0;
+
+	for(const auto & player : cb->getStartInfo()->playerInfos)
+	{
+		if(player.second.isControlledByAI())
+			aiPlayers++;
+	}
+
+	return totalLimit / std::max(1, aiPlayers);
+}
+
 AINodeStorage::AINodeStorage(const Nullkiller * ai, const int3 & Sizes)
-	: sizes(Sizes), ai(ai), cb(ai->cb.get()), nodes(Sizes)
+	: sizes(Sizes), ai(ai), cb(ai->cb.get()), nodes(Sizes, getPlayerMemoryLimit(ai->cb.get(), ai->settings->getPathfinderMemoryLimit()))
 {
-	accessibility = std::make_unique<boost::multi_array<EPathAccessibility, 4>>(
-		boost::extents[sizes.z][sizes.x][sizes.y][EPathfindingLayer::NUM_LAYERS]);
+	auto & grid = accessibilityGrids[ai->playerID];
+
+	grid = std::make_unique<AIAccessibilityGrid>(sizes);
+	accessibility = grid.get();
 }
 
 AINodeStorage::~AINodeStorage() = default;
@@ -106,13 +264,40 @@ void AINodeStorage::initialize(const PathfinderOptions & options, const CGameSta
 	if(heroChainPass != EHeroChainPass::INITIAL)
 		return;
 
-	AISharedStorage::version++;
+	nodes.nextVersion();
 
 	//TODO: fix this code duplication with NodeStorage::initialize, problem is to keep `resetTile` inline
 	const PlayerColor fowPlayer = ai->playerID;
 	const auto & fow = static_cast<const CGameInfoCallback *>(gs)->getPlayerTeam(fowPlayer)->fogOfWarMap;
 	const int3 sizes = gs->getMapSize();
 
+	auto & grid = accessibilityGrids[playerID];
+
+	if(!grid)
+		grid = std::make_unique<AIAccessibilityGrid>(sizes);
+
+	accessibility = grid.get();
+
+	if(accessibility->initialized
+		&& accessibility->useFlying == options.useFlying
+		&& accessibility->useWaterWalking == options.useWaterWalking)
+	{
+#if NKAI_PATHFINDER_TRACE_LEVEL >= 1
+		logAi->trace("Updating accessibility of %d changed tiles", accessibility->changedTiles.size());
+#endif
+		for(const int3 & pos : accessibility->changedTiles)
+		{
+			if(gs->isInTheMap(pos))
+				initializeTile(pos, options, gs, fow);
+		}
+
+		accessibility->changedTiles.clear();
+		return;
+	}
+
+	if(accessibility->initialized)
+		std::fill_n(accessibility->tiles.data(), accessibility->tiles.num_elements(), EPathAccessibility::NOT_SET);
+
 	//Each thread gets different x, but an array of y located next to each other in memory
 
 	tbb::parallel_for(tbb::blocked_range<size_t>(0, sizes.x), [&](const tbb::blocked_range<size_t>& r)
@@ -121,36 +306,60 @@ void AINodeStorage::initialize(const PathfinderOptions & options, const CGameSta
 
 		for(pos.z = 0; pos.z < sizes.z; ++pos.z)
 		{
-			const bool useFlying = options.useFlying;
-			const bool useWaterWalking = options.useWaterWalking;
-			const PlayerColor player = playerID;
-
 			for(pos.x = r.begin(); pos.x != r.end(); ++pos.x)
 			{
 				for(pos.y = 0; pos.y < sizes.y; ++pos.y)
 				{
-					const TerrainTile & tile = gs->map->getTile(pos);
-					if (!tile.terType->isPassable())
-						continue;
-
-					if (tile.terType->isWater())
-					{
-						resetTile(pos, ELayer::SAIL, PathfinderUtil::evaluateAccessibility<ELayer::SAIL>(pos, tile, fow, player, gs));
-						if (useFlying)
-							resetTile(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs));
-						if (useWaterWalking)
-							resetTile(pos, ELayer::WATER, PathfinderUtil::evaluateAccessibility<ELayer::WATER>(pos, tile, fow, player, gs));
-					}
-					else
-					{
-						resetTile(pos, ELayer::LAND, PathfinderUtil::evaluateAccessibility<ELayer::LAND>(pos, tile, fow, player, gs));
-						if (useFlying)
-							resetTile(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs));
-					}
+					initializeTile(pos, options, gs, fow);
 				}
 			}
 		}
 	});
+
+	accessibility->initialized = true;
+	accessibility->useFlying = options.useFlying;
+	accessibility->useWaterWalking = options.useWaterWalking;
+	accessibility->changedTiles.clear();
+}
+
+void AINodeStorage::initializeTile(const int3 & pos, const PathfinderOptions & options, const CGameState * gs, const boost::multi_array<ui8, 3> & fow)
+{
+	const TerrainTile & tile = gs->map->getTile(pos);
+	if (!tile.terType->isPassable())
+		return;
+
+	if (tile.terType->isWater())
+	{
+		resetTile(pos, ELayer::SAIL, PathfinderUtil::evaluateAccessibility<ELayer::SAIL>(pos, tile, fow, playerID, gs));
+		if (options.useFlying)
+			resetTile(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, playerID, gs));
+		if (options.useWaterWalking)
+			resetTile(pos, ELayer::WATER, PathfinderUtil::evaluateAccessibility<ELayer::WATER>(pos, tile, fow, playerID, gs));
+	}
+	else
+	{
+		resetTile(pos, ELayer::LAND, PathfinderUtil::evaluateAccessibility<ELayer::LAND>(pos, tile, fow, playerID, gs));
+		if (options.useFlying)
+			resetTile(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, playerID, gs));
+	}
+}
+
+void AINodeStorage::invalidateAccessibility()
+{
+	for(auto & grid : accessibilityGrids)
+	{
+		grid.second->initialized = false;
+		grid.second->changedTiles.clear();
+	}
+}
+
+void AINodeStorage::invalidateAccessibility(const std::unordered_set<int3> & tiles)
+{
+	for(auto & grid : accessibilityGrids)
+	{
+		if(grid.second->initialized)
+			grid.second->changedTiles.insert(tiles.begin(), tiles.end());
+	}
 }
 
 void AINodeStorage::clear()
@@ -169,23 +378,19 @@ std::optional<AIPathNode *> AINodeStorage::getOrCreateNode(
 	const EPathfindingLayer layer, 
 	const ChainActor * actor)
 {
-	int bucketIndex = ((uintptr_t)actor + static_cast<uint32_t>(layer)) % AIPathfinding::BUCKET_COUNT;
-	int bucketOffset = bucketIndex * AIPathfinding::BUCKET_SIZE;
-	auto chains = nodes.get(pos);
-
 	if(blocked(pos, layer))
 	{
 		return std::nullopt;
 	}
 
-	for(auto i = AIPathfinding::BUCKET_SIZE - 1; i >= 0; i--)
-	{
-		AIPathNode & node = chains[i + bucketOffset];
+	AITileChains & chains = nodes.getTile(pos);
 
-		if(node.version != AISharedStorage::version)
+	for(AIPathNode & node : AIChainRange(chains))
+	{
+		if(node.version != nodes.getVersion())
 		{
 			node.reset(layer, getAccessibility(pos, layer));
-			node.version = AISharedStorage::version;
+			node.version = nodes.getVersion();
 			node.actor = actor;
 
 			return &node;
@@ -197,6 +402,17 @@ std::optional<AIPathNode *> AINodeStorage::getOrCreateNode(
 		}
 	}
 
+	AIPathNode * chunk = nodes.allocateChunk(chains, pos);
+
+	if(chunk)
+	{
+		chunk->reset(layer, getAccessibility(pos, layer));
+		chunk->version = nodes.getVersion();
+		chunk->actor = actor;
+
+		return chunk;
+	}
+
 	return std::nullopt;
 }
 
@@ -223,7 +439,7 @@ std::vector<CGPathNode *> AINodeStorage::getInitialNodes()
 
 		AIPathNode * initialNode = allocated.value();
 
-		initialNode->pq = nullptr;
+		initialNode->queued = false;
 		initialNode->turns = actor->initialTurn;
 		initialNode->moveRemains = actor->initialMovement;
 		initialNode->danger = 0;
@@ -291,7 +507,7 @@ void AINodeStorage::commit(CDestinationNodeInfo & destination, const PathNodeInf
 				else
 					dstNode->armyLoss += (weakest->second->getCount() + 1) / 2 * weakest->second->getCreatureID().toCreature()->getAIValue();
 
-				dstNode->specialAction = AIPathfinding::WhirlpoolAction::instance;
+				setSpecialAction(dstNode, AIPathfinding::WhirlpoolAction::instance);
 			}
 		}
 
@@ -707,7 +923,7 @@ void HeroChainCalculationTask::calculateHeroChain(
 {
 	for(AIPathNode * node : variants)
 	{
-		if(node == srcNode || !node->actor || node->version != AISharedStorage::version)
+		if(node == srcNode || !node->actor || node->version != storage.getNodesVersion())
 			continue;
 
 		if((node->actor->chainMask & chainMask) == 0 && (srcNode->actor->chainMask & chainMask) == 0)
@@ -868,7 +1084,7 @@ void HeroChainCalculationTask::addHeroChain(const std::vector<ExchangeCandidate>
 		if(exchangeNode->actor->actorAction)
 		{
 			exchangeNode->theNodeBefore = carrier;
-			exchangeNode->addSpecialAction(exchangeNode->actor->actorAction);
+			storage.addSpecialAction(exchangeNode, exchangeNode->actor->actorAction);
 		}
 
 		exchangeNode->chainOther = other;
@@ -1154,7 +1370,7 @@ struct TownPortalFinder
 				DO_NOT_SAVE_TO_COMMITTED_TILES);
 
 			node->theNodeBefore = bestNode;
-			node->addSpecialAction(std::make_shared<AIPathfinding::TownPortalAction>(targetTown));
+			nodeStorage->addSpecialAction(node, std::make_shared<AIPathfinding::TownPortalAction>(targetTown));
 		}
 
 		return nodeOptional;
@@ -1389,7 +1605,7 @@ bool AINodeStorage::isTileAccessible(const HeroPtr & hero, const int3 & pos, con
 
 	for(const AIPathNode & node : chains)
 	{
-		if(node.version == AISharedStorage::version
+		if(node.version == nodes.getVersion()
 			&& node.layer == layer
 			&& node.action != EPathNodeAction::UNKNOWN 
 			&& node.actor
@@ -1409,7 +1625,7 @@ void AINodeStorage::calculateChainInfo(std::vector<AIPath> & paths, const int3 &
 
 	for(const AIPathNode & node : chains)
 	{
-		if(node.version != AISharedStorage::version
+		if(node.version != nodes.getVersion()
 			|| node.layer != layer
 			|| node.action == EPathNodeAction::UNKNOWN
 			|| !node.actor
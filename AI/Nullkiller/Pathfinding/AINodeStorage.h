@@ -29,9 +29,9 @@ namespace NKAI
 {
 namespace AIPathfinding
 {
-	const int BUCKET_COUNT = 1;
-	const int BUCKET_SIZE = 32;
-	const int NUM_CHAINS = BUCKET_COUNT * BUCKET_SIZE;
+	const int NUM_CHAINS = 32;
+	const int CHAIN_CHUNK_SIZE = 8;
+	const int MAX_CHAIN_CHUNKS = NUM_CHAINS / CHAIN_CHUNK_SIZE;
 	const int CHAIN_MAX_DEPTH = 4;
 }
 
@@ -42,9 +42,36 @@ enum DayFlags : ui8
 	WATER_WALK_CAST = 2
 };
 
+/// Reference to special action of path node. Actions are owned by chain pool of the storage so node keeps only
+/// a pointer instead of shared pointer copy. Pool releases actions when new pathfinder run starts, see AIChainPool::clear
+class SpecialActionRef
+{
+	static const std::shared_ptr<const SpecialAction> empty;
+
+	const std::shared_ptr<const SpecialAction> * action;
+
+public:
+	SpecialActionRef() : action(nullptr) {}
+
+	explicit SpecialActionRef(const std::shared_ptr<const SpecialAction> & owned)
+		: action(&owned)
+	{
+	}
+
+	void reset() { action = nullptr; }
+
+	explicit operator bool() const { return action != nullptr; }
+
+	const std::shared_ptr<const SpecialAction> & get() const { return action ? *action : empty; }
+
+	operator const std::shared_ptr<const SpecialAction> &() const { return get(); }
+
+	const SpecialAction * operator->() const { return action->get(); }
+};
+
 struct AIPathNode : public CGPathNode
 {
-	std::shared_ptr<const SpecialAction> specialAction;
+	SpecialActionRef specialAction;
 
 	const AIPathNode * chainOther;
 	const ChainActor * actor;
@@ -56,8 +83,6 @@ struct AIPathNode : public CGPathNode
 	int16_t manaCost;
 	DayFlags dayFlags;
 
-	void addSpecialAction(std::shared_ptr<const SpecialAction> action);
-
 	inline void reset(EPathfindingLayer layer, EPathAccessibility accessibility)
 	{
 		CGPathNode::reset();
@@ -147,23 +172,152 @@ enum EHeroChainPass
 	FINAL // same as SINGLE but for heroes from CHAIN pass
 };
 
-class AISharedStorage
+/// Accessibility of tiles for actors of one owner, shared by all actors and passes.
+/// It persists between pathfinder runs and only changed tiles are evaluated again, see AINodeStorage::invalidateAccessibility
+struct AIAccessibilityGrid
+{
+	// [z][x][y][layer] - position on map
+	boost::multi_array<EPathAccessibility, 4> tiles;
+	bool initialized;
+	bool useFlying;
+	bool useWaterWalking;
+	std::unordered_set<int3> changedTiles;
+
+	AIAccessibilityGrid(const int3 & sizes);
+};
+
+/// Chain nodes of one tile. Nodes are allocated by chunks of CHAIN_CHUNK_SIZE when tile is reached
+struct AITileChains
+{
+	uint32_t version;
+	uint8_t chunksCount;
+	std::array<AIPathNode *, AIPathfinding::MAX_CHAIN_CHUNKS> chunks;
+};
+
+class AIChainRange
+{
+	AIPathNode * const * chunks;
+	int size;
+
+public:
+	class iterator
+	{
+		AIPathNode * const * chunks;
+		int index;
+
+	public:
+		iterator(AIPathNode * const * chunks, int index) : chunks(chunks), index(index) {}
+
+		AIPathNode & operator*() const
+		{
+			return chunks[index / AIPathfinding::CHAIN_CHUNK_SIZE][index % AIPathfinding::CHAIN_CHUNK_SIZE];
+		}
+
+		iterator & operator++()
+		{
+			index++;
+			return *this;
+		}
+
+		bool operator!=(const iterator & other) const { return index != other.index; }
+	};
+
+	AIChainRange() : chunks(nullptr), size(0) {}
+	AIChainRange(const AITileChains & tile) : chunks(tile.chunks.data()), size(tile.chunksCount * AIPathfinding::CHAIN_CHUNK_SIZE) {}
+
+	iterator begin() const { return iterator(chunks, 0); }
+	iterator end() const { return iterator(chunks, size); }
+};
+
+/// Chain nodes of one AI player. Only tiles reached by pathfinder get nodes so memory usage depends on
+/// explored area instead of map size. All nodes are released at once when version changes.
+/// First chunk of every reached tile is always available. Further chunks are limited by share of
+/// Settings::getPathfinderMemoryLimit - once it is used up, tiles get fewer chains but remain reachable
+class AIChainPool
 {
-	// 1-3 - position on map[z][x][y]
-	// 4 - chain + layer (normal, battle, spellcast and combinations, water, air)
-	static std::shared_ptr<boost::multi_array<AIPathNode, 4>> shared;
-	std::shared_ptr<boost::multi_array<AIPathNode, 4>> nodes;
+	static constexpr size_t TILE_LOCK_COUNT = 64;
+
+	// [z][x][y] - position on map
+	boost::multi_array<AITileChains, 3> tiles;
+	// blocks are created on first use and kept until pool is destroyed
+	std::vector<std::atomic<AIPathNode *>> blocks;
+	boost::mutex blocksLock;
+	std::array<boost::mutex, TILE_LOCK_COUNT> tileLocks;
+	std::atomic<size_t> allocatedChunks;
+	std::atomic<size_t> extraChunks;
+	size_t maxExtraChunks;
+	std::atomic<bool> exhaustionLogged;
+	boost::mutex actionsLock;
+	std::unordered_map<const SpecialAction *, std::shared_ptr<const SpecialAction>> actions;
+
+	AIPathNode * getBlock(size_t blockIndex);
+	bool reserveExtraChunk(uint8_t chunksCount);
+
 public:
-	static boost::mutex locker;
-	static uint32_t version;
+	static constexpr size_t CHUNKS_PER_BLOCK = 1024;
+
+	AIChainPool(const int3 & sizes, size_t memoryLimit);
+	~AIChainPool();
+
+	/// Releases all chunks and special actions, called when version changes
+	void clear();
+
+	AITileChains & getTile(const int3 & tile, uint32_t version);
+	const AITileChains * findTile(const int3 & tile, uint32_t version) const;
+
+	/// Thread safe, returns nullptr if tile has all chunks or memory limit does not allow next chunk for it
+	AIPathNode * allocateChunk(AITileChains & tile, const int3 & pos);
 
-	AISharedStorage(int3 mapSize);
+	/// Thread safe, keeps action alive until pool is cleared
+	SpecialActionRef retainAction(std::shared_ptr<const SpecialAction> action);
+
+	size_t getMemoryUsage() const;
+};
+
+/// Chain nodes used by all actors of one AI player. Each AI player has own storage so several players
+/// may calculate paths at the same time
+class AISharedStorage
+{
+	std::unique_ptr<AIChainPool> nodes;
+	uint32_t version;
+
+public:
+	AISharedStorage(int3 mapSize, size_t memoryLimit);
 	~AISharedStorage();
 
+	/// Starts new pathfinder run, all existing nodes become free
+	void nextVersion();
+
+	uint32_t getVersion() const { return version; }
+
+	STRONG_INLINE
+	AIChainRange get(int3 tile) const
+	{
+		auto chains = nodes->findTile(tile, version);
+
+		return chains ? AIChainRange(*chains) : AIChainRange();
+	}
+
+	STRONG_INLINE
+	AITileChains & getTile(int3 tile)
+	{
+		return nodes->getTile(tile, version);
+	}
+
 	STRONG_INLINE
-	boost::detail::multi_array::sub_array<AIPathNode, 1> get(int3 tile) const
+	AIPathNode * allocateChunk(AITileChains & tile, const int3 & pos)
 	{
-		return (*nodes)[tile.z][tile.x][tile.y];
+		return nodes->allocateChunk(tile, pos);
+	}
+
+	SpecialActionRef retainAction(std::shared_ptr<const SpecialAction> action)
+	{
+		return nodes->retainAction(action);
+	}
+
+	size_t getMemoryUsage() const
+	{
+		return nodes->getMemoryUsage();
 	}
 };
 
@@ -172,7 +326,9 @@ class AINodeStorage : public INodeStorage
 private:
 	int3 sizes;
 
-	std::unique_ptr<boost::multi_array<EPathAccessibility, 4>> accessibility;
+	/// Accessibility by owner of actors, danger hit map calculates paths of enemy heroes so each owner keeps own grid
+	std::map<PlayerColor, std::unique_ptr<AIAccessibilityGrid>> accessibilityGrids;
+	AIAccessibilityGrid * accessibility; // grid of current actors owner
 
 	const CPlayerSpecificInfoCallback * cb;
 	const Nullkiller * ai;
@@ -185,6 +341,8 @@ private:
 	int heroChainMaxTurns;
 	PlayerColor playerID;
 	uint8_t turnDistanceLimit[2];
+	mutable std::set<int3> committedTiles;
+	std::set<int3> committedTilesInitial;
 
 public:
 	/// more than 1 chain layer for each hero allows us to have more than 1 path to each tile so we can chose more optimal one.	
@@ -192,6 +350,8 @@ public:
 	~AINodeStorage();
 
 	void initialize(const PathfinderOptions & options, const CGameState * gs) override;
+	void invalidateAccessibility();
+	void invalidateAccessibility(const std::unordered_set<int3> & tiles);
 
 	bool increaseHeroChainTurnLimit();
 	bool selectFirstActor();
@@ -222,6 +382,15 @@ public:
 		float cost,
 		bool saveToCommitted = true) const;
 
+	/// Replaces special action of the node, action is kept alive by this storage. Thread safe
+	void setSpecialAction(AIPathNode * node, std::shared_ptr<const SpecialAction> action);
+
+	/// Combines special action of the node with new one. Thread safe
+	void addSpecialAction(AIPathNode * node, std::shared_ptr<const SpecialAction> action);
+
+	/// Nodes with other version are left from previous pathfinder runs and are treated as free
+	uint32_t getNodesVersion() const { return nodes.getVersion(); }
+
 	inline const AIPathNode * getAINode(const CGPathNode * node) const
 	{
 		return static_cast<const AIPathNode *>(node);
@@ -288,18 +457,15 @@ public:
 
 	inline EPathAccessibility getAccessibility(const int3 & tile, EPathfindingLayer layer) const
 	{
-		return (*this->accessibility)[tile.z][tile.x][tile.y][layer];
+		return accessibility->tiles[tile.z][tile.x][tile.y][layer];
 	}
 
 	inline void resetTile(const int3 & tile, EPathfindingLayer layer, EPathAccessibility tileAccessibility)
 	{
-		(*this->accessibility)[tile.z][tile.x][tile.y][layer] = tileAccessibility;
+		accessibility->tiles[tile.z][tile.x][tile.y][layer] = tileAccessibility;
 	}
 
-	inline int getBucket(const ChainActor * actor) const
-	{
-		return ((uintptr_t)actor * 395) % AIPathfinding::BUCKET_COUNT;
-	}
+	void initializeTile(const int3 & pos, const PathfinderOptions & options, const CGameState * gs, const boost::multi_array<ui8, 3> & fow);
 
 	void calculateTownPortalTeleportations(std::vector<CGPathNode *> & neighbours);
 	void fillChainInfo(const AIPathNode * node, AIPath & path, int parentIndex) const;
@@ -314,7 +480,7 @@ public:
 
 		for(AIPathNode & node : chains)
 		{
-			if(node.version != AISharedStorage::version || node.layer != layer)
+			if(node.version != nodes.getVersion() || node.layer != layer)
 				continue;
 
 			fn(node);
@@ -331,7 +497,7 @@ public:
 
 		for(AIPathNode & node : chains)
 		{
-			if(node.version != AISharedStorage::version || node.layer != layer)
+			if(node.version != nodes.getVersion() || node.layer != layer)
 				continue;
 
 			if(predicate(node))
@@ -11,17 +11,52 @@
 #include "AIPathfinder.h"
 #include "AIPathfinderConfig.h"
 #include "../../../CCallback.h"
+#include "../../../lib/PerformanceStatistics.h"
 #include "../../../lib/mapping/CMap.h"
 #include "../Engine/Nullkiller.h"
 
 namespace NKAI
 {
 
-std::map<ObjectInstanceID, std::unique_ptr<GraphPaths>>  AIPathfinder::heroGraphs;
-
 AIPathfinder::AIPathfinder(CPlayerSpecificInfoCallback * cb, Nullkiller * ai)
-	:cb(cb), ai(ai)
+	:cb(cb), ai(ai), generation(0), accessibilityOutdated(true)
+{
+}
+
+void AIPathfinder::invalidateAccessibility()
 {
+	boost::lock_guard<boost::mutex> lock(accessibilityMutex);
+
+	accessibilityOutdated = true;
+	changedTiles.clear();
+}
+
+void AIPathfinder::invalidateAccessibility(const std::unordered_set<int3> & tiles)
+{
+	boost::lock_guard<boost::mutex> lock(accessibilityMutex);
+
+	if(!accessibilityOutdated)
+		changedTiles.insert(tiles.begin(), tiles.end());
+}
+
+void AIPathfinder::invalidateAccessibility(const CGObjectInstance * obj)
+{
+	std::unordered_set<int3> tiles;
+	std::set<int3> objectTiles = obj->getBlockedPos();
+
+	objectTiles.insert(obj->visitablePos());
+
+	// neighbour tiles are included since object may guard them
+	for(const int3 & tile : objectTiles)
+	{
+		for(int dx = -1; dx <= 1; dx++)
+		{
+			for(int dy = -1; dy <= 1; dy++)
+				tiles.insert(tile + int3(dx, dy, 0));
+		}
+	}
+
+	invalidateAccessibility(tiles);
 }
 
 void AIPathfinder::init()
@@ -75,6 +110,8 @@ void AIPathfinder::calculatePathInfo(std::vector<AIPath> & result, const int3 &
 
 void AIPathfinder::updatePaths(const std::map<const CGHeroInstance *, HeroRole> & heroes, PathfinderSettings pathfinderSettings)
 {
+	PerformanceTimer timer("AIPathfinder::updatePaths");
+
 	if(!storage)
 	{
 		storage.reset(new AINodeStorage(ai, cb->getMapSize()));
@@ -84,8 +121,21 @@ void AIPathfinder::updatePaths(const std::map<const CGHeroInstance *, HeroRole>
 	logAi->debug("Recalculate all paths");
 	int pass = 0;
 
+	generation++;
 	storage->clear();
 	storage->setHeroes(heroes);
+
+	{
+		boost::lock_guard<boost::mutex> lock(accessibilityMutex);
+
+		if(accessibilityOutdated)
+			storage->invalidateAccessibility();
+		else
+			storage->invalidateAccessibility(changedTiles);
+
+		accessibilityOutdated = false;
+		changedTiles.clear();
+	}
 	storage->setScoutTurnDistanceLimit(pathfinderSettings.scoutTurnDistanceLimit);
 	storage->setMainTurnDistanceLimit(pathfinderSettings.mainTurnDistanceLimit);
 
@@ -151,8 +201,15 @@ void AIPathfinder::updateGraphs(
 {
 	auto start = std::chrono::high_resolution_clock::now();
 	std::vector<const CGHeroInstance *> heroesVector;
+	auto heroesGraph = std::make_shared<ObjectGraph>(cb->getMapSize());
+
+	// connections to our heroes are same for all of them so they are calculated once
+	heroesGraph->copyFrom(*ai->baseGraph);
+	heroesGraph->connectHeroes(ai);
+	heroesGraph->compact();
 
 	heroGraphs.clear();
+	generation++;
 
 	for(auto hero : heroes)
 	{
@@ -163,14 +220,14 @@ void AIPathfinder::updateGraphs(
 		}
 	}
 
-	tbb::parallel_for(tbb::blocked_range<size_t>(0, heroesVector.size()), [this, &heroesVector, &heroes, mainScanDepth, scoutScanDepth](const tbb::blocked_range<size_t> & r)
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, heroesVector.size()), [this, &heroesVector, &heroes, &heroesGraph, mainScanDepth, scoutScanDepth](const tbb::blocked_range<size_t> & r)
 		{
 			for(auto i = r.begin(); i != r.end(); i++)
 			{
 				auto role = heroes.at(heroesVector[i]);
 				auto scanLimit = role == HeroRole::MAIN ? mainScanDepth : scoutScanDepth;
 
-				heroGraphs.at(heroesVector[i]->id)->calculatePaths(heroesVector[i], ai, scanLimit);
+				heroGraphs.at(heroesVector[i]->id)->calculatePaths(heroesVector[i], ai, scanLimit, heroesGraph);
 			}
 		});
 
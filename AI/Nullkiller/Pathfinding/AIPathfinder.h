@@ -41,7 +41,13 @@ private:
 	std::shared_ptr<AINodeStorage> storage;
 	CPlayerSpecificInfoCallback * cb;
 	Nullkiller * ai;
-	static std::map<ObjectInstanceID, std::unique_ptr<GraphPaths>>  heroGraphs;
+	std::map<ObjectInstanceID, std::unique_ptr<GraphPaths>> heroGraphs;
+	uint32_t generation;
+
+	/// Changes of map reported by events, applied to storage accessibility on next paths update
+	boost::mutex accessibilityMutex;
+	bool accessibilityOutdated;
+	std::unordered_set<int3> changedTiles;
 
 public:
 	AIPathfinder(CPlayerSpecificInfoCallback * cb, Nullkiller * ai);
@@ -52,6 +58,13 @@ public:
 	void calculateQuickPathsWithBlocker(std::vector<AIPath> & result, const std::vector<const CGHeroInstance *> & heroes, const int3 & tile);
 	void init();
 
+	/// Increased each time paths or graph paths are calculated again, anything built from paths is outdated then
+	uint32_t getGeneration() const { return generation; }
+
+	void invalidateAccessibility();
+	void invalidateAccessibility(const std::unordered_set<int3> & tiles);
+	void invalidateAccessibility(const CGObjectInstance * obj);
+
 	std::shared_ptr<AINodeStorage>getStorage()
 	{
 		return storage;
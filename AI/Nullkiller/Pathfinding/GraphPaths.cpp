@@ -53,10 +53,9 @@ std::shared_ptr<SpecialAction> getCompositeAction(
 	return std::make_shared<CompositeAction>(actionsArray);
 }
 
-void GraphPaths::calculatePaths(const CGHeroInstance * targetHero, const Nullkiller * ai, uint8_t scanDepth)
+void GraphPaths::calculatePaths(const CGHeroInstance * targetHero, const Nullkiller * ai, uint8_t scanDepth, std::shared_ptr<const ObjectGraph> heroesGraph)
 {
-	graph.copyFrom(*ai->baseGraph);
-	graph.connectHeroes(ai);
+	graph = heroesGraph;
 
 	visualKey = std::to_string(ai->playerID) + ":" + targetHero->getNameTranslated();
 	pathNodes.clear();
@@ -102,7 +101,7 @@ void GraphPaths::calculatePaths(const CGHeroInstance * targetHero, const Nullkil
 
 		node.isInQueue = false;
 
-		graph.iterateConnections(pos.coord, [this, ai, &pos, &node, &transitionAction, &pq, scanDepth](int3 target, const ObjectLink & o)
+		graph->iterateConnections(pos.coord, [this, ai, &pos, &node, &transitionAction, &pq, scanDepth](int3 target, const ObjectLink & o)
 			{
 				auto compositeAction = getCompositeAction(ai, o.specialAction, transitionAction);
 				auto targetNodeType = o.danger || compositeAction ? GrapthPathNodeType::BATTLE : pos.nodeType;
@@ -118,7 +117,7 @@ void GraphPaths::calculatePaths(const CGHeroInstance * targetHero, const Nullkil
 
 					targetNode.specialAction = compositeAction;
 
-					const auto & targetGraphNode = graph.getNode(target);
+					const auto & targetGraphNode = graph->getNode(target);
 
 					if(targetGraphNode.objID.hasValue())
 					{
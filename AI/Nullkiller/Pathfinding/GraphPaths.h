@@ -12,6 +12,8 @@
 
 #include "ObjectGraph.h"
 
+#include <boost/heap/fibonacci_heap.hpp>
+
 namespace NKAI
 {
 
@@ -86,13 +88,14 @@ struct GraphPathNode
 
 class GraphPaths
 {
-	ObjectGraph graph;
+	std::shared_ptr<const ObjectGraph> graph;
 	GraphNodeStorage pathNodes;
 	std::string visualKey;
 
 public:
 	GraphPaths();
-	void calculatePaths(const CGHeroInstance * targetHero, const Nullkiller * ai, uint8_t scanDepth);
+	/// Graph is shared by paths of all heroes, it contains base graph of AI and connections to our heroes
+	void calculatePaths(const CGHeroInstance * targetHero, const Nullkiller * ai, uint8_t scanDepth, std::shared_ptr<const ObjectGraph> heroesGraph);
 	void addChainInfo(std::vector<AIPath> & paths, int3 tile, const CGHeroInstance * hero, const Nullkiller * ai) const;
 	void quickAddChainInfoWithBlocker(std::vector<AIPath> & paths, int3 tile, const CGHeroInstance * hero, const Nullkiller * ai) const;
 	void dumpToLog() const;
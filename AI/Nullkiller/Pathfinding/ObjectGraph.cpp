@@ -19,18 +19,85 @@
 #include "Actions/QuestAction.h"
 #include "../pforeach.h"
 #include "Actions/BoatActions.h"
+#include "../../../lib/PerformanceStatistics.h"
 
 namespace NKAI
 {
 
+ObjectGraph::ObjectGraph(const int3 & mapSize)
+	:mapSize(mapSize), tileNodes(static_cast<size_t>(mapSize.x) * mapSize.y * mapSize.z, NO_NODE)
+{
+}
+
+ObjectNode & ObjectGraph::getOrCreateNode(const int3 & tile)
+{
+	auto & index = tileNodes[(tile.z * mapSize.x + tile.x) * mapSize.y + tile.y];
+
+	if(index == NO_NODE)
+	{
+		index = nodes.size();
+		nodes.emplace_back().pos = tile;
+		nodes.back().initJunction();
+		addedConnections.emplace_back();
+	}
+
+	return nodes[index];
+}
+
+ObjectLink * ObjectGraph::findConnection(uint32_t from, uint32_t to)
+{
+	if(from + 1 < connectionOffsets.size())
+	{
+		for(uint32_t i = connectionOffsets[from]; i < connectionOffsets[from + 1]; i++)
+		{
+			if(connections[i].target == to)
+				return &connections[i].link;
+		}
+	}
+
+	for(auto & connection : addedConnections[from])
+	{
+		if(connection.target == to)
+			return &connection.link;
+	}
+
+	return nullptr;
+}
+
+ObjectLink & ObjectGraph::findOrAddConnection(uint32_t from, uint32_t to)
+{
+	ObjectLink * connection = findConnection(from, to);
+
+	if(connection)
+		return *connection;
+
+	addedConnections[from].push_back(ObjectConnection{to, ObjectLink()});
+
+	return addedConnections[from].back().link;
+}
+
+const ObjectLink * ObjectGraph::getConnection(const int3 & from, const int3 & to) const
+{
+	uint32_t fromIndex = getNodeIndex(from);
+	uint32_t toIndex = getNodeIndex(to);
+
+	if(fromIndex == NO_NODE || toIndex == NO_NODE)
+		return nullptr;
+
+	return const_cast<ObjectGraph *>(this)->findConnection(fromIndex, toIndex);
+}
+
 bool ObjectGraph::tryAddConnection(
 	const int3 & from,
 	const int3 & to,
 	float cost,
 	uint64_t danger)
 {
-	auto result =  nodes[from].connections[to].update(cost, danger);
-	auto & connection = nodes[from].connections[to];
+	getOrCreateNode(from);
+	getOrCreateNode(to);
+
+	auto & connection = findOrAddConnection(getNodeIndex(from), getNodeIndex(to));
+	auto result = connection.update(cost, danger);
 
 	if(result && isVirtualBoat(to) && !connection.specialAction)
 	{
@@ -42,12 +109,108 @@ bool ObjectGraph::tryAddConnection(
 
 void ObjectGraph::removeConnection(const int3 & from, const int3 & to)
 {
-	nodes[from].connections.erase(to);
+	uint32_t fromIndex = getNodeIndex(from);
+	uint32_t toIndex = getNodeIndex(to);
+
+	if(fromIndex == NO_NODE || toIndex == NO_NODE)
+		return;
+
+	if(fromIndex + 1 < connectionOffsets.size())
+	{
+		for(uint32_t i = connectionOffsets[fromIndex]; i < connectionOffsets[fromIndex + 1]; i++)
+		{
+			// removed connections stay in packed array until next compaction
+			if(connections[i].target == toIndex)
+				connections[i].target = NO_NODE;
+		}
+	}
+
+	vstd::erase_if(addedConnections[fromIndex], [toIndex](const ObjectConnection & connection) -> bool
+		{
+			return connection.target == toIndex;
+		});
+}
+
+void ObjectGraph::compact()
+{
+	std::vector<uint32_t> newOffsets;
+	std::vector<ObjectConnection> newConnections;
+
+	newOffsets.reserve(nodes.size() + 1);
+	newConnections.reserve(getConnectionsCount());
+
+	for(uint32_t index = 0; index < nodes.size(); index++)
+	{
+		newOffsets.push_back(newConnections.size());
+
+		if(index + 1 < connectionOffsets.size())
+		{
+			for(uint32_t i = connectionOffsets[index]; i < connectionOffsets[index + 1]; i++)
+			{
+				if(connections[i].target != NO_NODE)
+					newConnections.push_back(std::move(connections[i]));
+			}
+		}
+
+		vstd::concatenate(newConnections, addedConnections[index]);
+		addedConnections[index].clear();
+	}
+
+	newOffsets.push_back(newConnections.size());
+
+	connectionOffsets = std::move(newOffsets);
+	connections = std::move(newConnections);
+}
+
+size_t ObjectGraph::getConnectionsCount() const
+{
+	size_t result = 0;
+
+	for(auto & connection : connections)
+	{
+		if(connection.target != NO_NODE)
+			result++;
+	}
+
+	for(auto & added : addedConnections)
+	{
+		result += added.size();
+	}
+
+	return result;
+}
+
+size_t ObjectGraph::getMemoryUsage() const
+{
+	size_t result = tileNodes.capacity() * sizeof(uint32_t)
+		+ nodes.capacity() * sizeof(ObjectNode)
+		+ connectionOffsets.capacity() * sizeof(uint32_t)
+		+ connections.capacity() * sizeof(ObjectConnection);
+
+	for(auto & added : addedConnections)
+	{
+		result += added.capacity() * sizeof(ObjectConnection);
+	}
+
+	return result;
+}
+
+void ObjectGraph::logStatistics(const std::string & action, uint64_t timeMs) const
+{
+	logAi->debug(
+		"Object graph %s in %d ms: %d nodes, %d connections, %d KB",
+		action,
+		timeMs,
+		getNodesCount(),
+		getConnectionsCount(),
+		getMemoryUsage() / 1024);
 }
 
 void ObjectGraph::updateGraph(const Nullkiller * ai)
 {
-	auto cb = ai->cb;
+	PerformanceTimer timer("ObjectGraph::updateGraph");
+
+	auto start = std::chrono::high_resolution_clock::now();
 
 	ObjectGraphCalculator calculator(this, ai);
 
@@ -56,14 +219,62 @@ void ObjectGraph::updateGraph(const Nullkiller * ai)
 	calculator.addMinimalDistanceJunctions();
 	calculator.calculateConnections();
 
+	compact();
+
 	if(NKAI_GRAPH_TRACE_LEVEL >= 1)
 		dumpToLog("graph");
+
+	logStatistics("calculated", timeElapsed(start));
+}
+
+void ObjectGraph::addNewObjects(const Nullkiller * ai)
+{
+	std::vector<const CGObjectInstance *> objects;
+
+	{
+		boost::lock_guard<boost::mutex> lock(newObjectsLock);
+
+		for(auto id : newObjects)
+		{
+			auto obj = ai->cb->getObj(id, false);
+
+			if(obj && !hasNodeAt(obj->visitablePos()))
+				objects.push_back(obj);
+		}
+
+		newObjects.clear();
+	}
+
+	if(objects.empty())
+		return;
+
+	PerformanceTimer timer("ObjectGraph::addNewObjects");
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	ObjectGraphCalculator calculator(this, ai);
+
+	calculator.connectObjects(objects);
+
+	compact();
+
+	logStatistics("updated with " + std::to_string(objects.size()) + " new objects", timeElapsed(start));
 }
 
 void ObjectGraph::addObject(const CGObjectInstance * obj)
 {
 	if(!hasNodeAt(obj->visitablePos()))
-		nodes[obj->visitablePos()].init(obj);
+		getOrCreateNode(obj->visitablePos()).init(obj);
+}
+
+void ObjectGraph::markObjectAdded(const CGObjectInstance * obj)
+{
+	if(!obj->isVisitable() || obj->ID == Obj::HERO || obj->ID == Obj::EVENT)
+		return;
+
+	boost::lock_guard<boost::mutex> lock(newObjectsLock);
+
+	newObjects.push_back(obj->id);
 }
 
 void ObjectGraph::addVirtualBoat(const int3 & pos, const CGObjectInstance * shipyard)
@@ -76,23 +287,34 @@ void ObjectGraph::addVirtualBoat(const int3 & pos, const CGObjectInstance * ship
 
 void ObjectGraph::registerJunction(const int3 & pos)
 {
-	if(!hasNodeAt(pos))
-		nodes[pos].initJunction();
-
+	getOrCreateNode(pos);
 }
 
 void ObjectGraph::removeObject(const CGObjectInstance * obj)
 {
-	nodes[obj->visitablePos()].objectExists = false;
+	uint32_t index = getNodeIndex(obj->visitablePos());
+
+	if(index == NO_NODE)
+		return;
+
+	nodes[index].objectExists = false;
 
 	if(obj->ID == Obj::BOAT && !isVirtualBoat(obj->visitablePos()))
 	{
-		vstd::erase_if(nodes[obj->visitablePos()].connections, [&](const std::pair<int3, ObjectLink> & link) -> bool
+		std::vector<int3> waterTiles;
+
+		iterateConnections(obj->visitablePos(), [&](const int3 & target, const ObjectLink & link)
 			{
-				auto tile = cb->getTile(link.first, false);
+				auto tile = cb->getTile(target, false);
 
-				return tile && tile->isWater();
+				if(tile && tile->isWater())
+					waterTiles.push_back(target);
 			});
+
+		for(auto & target : waterTiles)
+		{
+			removeConnection(obj->visitablePos(), target);
+		}
 	}
 }
 
@@ -106,10 +328,14 @@ void ObjectGraph::connectHeroes(const Nullkiller * ai)
 		}
 	}
 
-	for(auto & node : nodes)
+	std::vector<AIPath> paths;
+	size_t nodesCount = nodes.size();
+
+	for(size_t i = 0; i < nodesCount; i++)
 	{
-		auto pos = node.first;
-		auto paths = ai->pathfinder->getPathInfo(pos);
+		auto pos = nodes[i].pos;
+
+		ai->pathfinder->calculatePathInfo(paths, pos);
 
 		for(AIPath & path : paths)
 		{
@@ -117,14 +343,11 @@ void ObjectGraph::connectHeroes(const Nullkiller * ai)
 				continue;
 
 			auto heroPos = path.targetHero->visitablePos();
+			auto cost = std::max(0.0f, path.movementCost());
 
-			nodes[pos].connections[heroPos].update(
-				std::max(0.0f, path.movementCost()),
-				path.getPathDanger());
-
-			nodes[heroPos].connections[pos].update(
-				std::max(0.0f, path.movementCost()),
-				path.getPathDanger());
+			getOrCreateNode(heroPos);
+			findOrAddConnection(i, getNodeIndex(heroPos)).update(cost, path.getPathDanger());
+			findOrAddConnection(getNodeIndex(heroPos), i).update(cost, path.getPathDanger());
 		}
 	}
 }
@@ -133,22 +356,22 @@ void ObjectGraph::dumpToLog(std::string visualKey) const
 {
 	logVisual->updateWithLock(visualKey, [&](IVisualLogBuilder & logBuilder)
 		{
-			for(auto & tile : nodes)
+			for(auto & node : nodes)
 			{
-				for(auto & node : tile.second.connections)
-				{
-					if(NKAI_GRAPH_TRACE_LEVEL >= 2)
+				iterateConnections(node.pos, [&](const int3 & target, const ObjectLink & link)
 					{
-						logAi->trace(
-							"%s -> %s: %f !%d",
-							node.first.toString(),
-							tile.first.toString(),
-							node.second.cost,
-							node.second.danger);
-					}
-
-					logBuilder.addLine(tile.first, node.first);
-				}
+						if(NKAI_GRAPH_TRACE_LEVEL >= 2)
+						{
+							logAi->trace(
+								"%s -> %s: %f !%d",
+								target.toString(),
+								node.pos.toString(),
+								link.cost,
+								link.danger);
+						}
+
+						logBuilder.addLine(node.pos, target);
+					});
 			}
 		});
 }
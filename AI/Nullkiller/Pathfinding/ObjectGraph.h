@@ -40,10 +40,10 @@ struct ObjectLink
 
 struct ObjectNode
 {
+	int3 pos;
 	ObjectInstanceID objID;
 	MapObjectID objTypeID;
 	bool objectExists;
-	std::unordered_map<int3, ObjectLink> connections;
 
 	void init(const CGObjectInstance * obj)
 	{
@@ -60,26 +60,63 @@ struct ObjectNode
 	}
 };
 
+struct ObjectConnection
+{
+	uint32_t target;
+	ObjectLink link;
+};
+
+/// Graph of objects kept by AI between turns. Nodes are stored densely and found by tile through lookup table.
+/// Connections of all nodes are packed in single array (compressed sparse row), connections added since last
+/// compaction are kept in small per node lists until compact is called
 class ObjectGraph
 {
-	std::unordered_map<int3, ObjectNode> nodes;
+	static constexpr uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+
+	int3 mapSize;
+	std::vector<uint32_t> tileNodes;
+	std::vector<ObjectNode> nodes;
+	std::vector<uint32_t> connectionOffsets;
+	std::vector<ObjectConnection> connections;
+	std::vector<std::vector<ObjectConnection>> addedConnections;
 	std::unordered_map<int3, ObjectInstanceID> virtualBoats;
 
-public:
-	ObjectGraph()
-		:nodes(), virtualBoats()
+	/// Objects reported by events, connected to graph on next update
+	boost::mutex newObjectsLock;
+	std::vector<ObjectInstanceID> newObjects;
+
+	uint32_t getNodeIndex(const int3 & tile) const
 	{
+		return tileNodes[(tile.z * mapSize.x + tile.x) * mapSize.y + tile.y];
 	}
 
+	ObjectNode & getOrCreateNode(const int3 & tile);
+	ObjectLink * findConnection(uint32_t from, uint32_t to);
+	ObjectLink & findOrAddConnection(uint32_t from, uint32_t to);
+
+public:
+	ObjectGraph(const int3 & mapSize);
+
 	void updateGraph(const Nullkiller * ai);
+	void addNewObjects(const Nullkiller * ai);
 	void addObject(const CGObjectInstance * obj);
+	/// Thread safe, object gets connected on next addNewObjects
+	void markObjectAdded(const CGObjectInstance * obj);
 	void registerJunction(const int3 & pos);
 	void addVirtualBoat(const int3 & pos, const CGObjectInstance * shipyard);
 	void connectHeroes(const Nullkiller * ai);
 	void removeObject(const CGObjectInstance * obj);
 	bool tryAddConnection(const int3 & from, const int3 & to, float cost, uint64_t danger);
 	void removeConnection(const int3 & from, const int3 & to);
+	const ObjectLink * getConnection(const int3 & from, const int3 & to) const;
+	/// Moves connections added since last call to packed array and drops removed ones
+	void compact();
 	void dumpToLog(std::string visualKey) const;
+	void logStatistics(const std::string & action, uint64_t timeMs) const;
+
+	size_t getNodesCount() const { return nodes.size(); }
+	size_t getConnectionsCount() const;
+	size_t getMemoryUsage() const;
 
 	bool isVirtualBoat(const int3 & tile) const
 	{
@@ -88,27 +125,55 @@ public:
 
 	void copyFrom(const ObjectGraph & other)
 	{
+		mapSize = other.mapSize;
+		tileNodes = other.tileNodes;
 		nodes = other.nodes;
+		connectionOffsets = other.connectionOffsets;
+		connections = other.connections;
+		addedConnections = other.addedConnections;
 		virtualBoats = other.virtualBoats;
 	}
 
 	template<typename Func>
-	void iterateConnections(const int3 & pos, Func fn)
+	void iterateConnections(const int3 & pos, Func fn) const
+	{
+		uint32_t index = getNodeIndex(pos);
+
+		if(index == NO_NODE)
+			return;
+
+		if(index + 1 < connectionOffsets.size())
+		{
+			for(uint32_t i = connectionOffsets[index]; i < connectionOffsets[index + 1]; i++)
+			{
+				if(connections[i].target != NO_NODE)
+					fn(nodes[connections[i].target].pos, connections[i].link);
+			}
+		}
+
+		for(auto & connection : addedConnections[index])
+		{
+			fn(nodes[connection.target].pos, connection.link);
+		}
+	}
+
+	template<typename Func>
+	void iterateNodes(Func fn) const
 	{
-		for(auto & connection : nodes.at(pos).connections)
+		for(auto & node : nodes)
 		{
-			fn(connection.first, connection.second);
+			fn(node.pos, node);
 		}
 	}
 
 	const ObjectNode & getNode(int3 tile) const
 	{
-		return nodes.at(tile);
+		return nodes.at(getNodeIndex(tile));
 	}
 
 	bool hasNodeAt(const int3 & tile) const
 	{
-		return vstd::contains(nodes, tile);
+		return getNodeIndex(tile) != NO_NODE;
 	}
 };
 
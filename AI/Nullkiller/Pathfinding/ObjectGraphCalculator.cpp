@@ -56,6 +56,46 @@ void ObjectGraphCalculator::calculateConnections()
 	removeExtraConnections();
 }
 
+void ObjectGraphCalculator::connectObjects(const std::vector<const CGObjectInstance *> & objects)
+{
+	for(auto obj : objects)
+	{
+		addObjectActor(obj);
+	}
+
+	updatePaths();
+
+	std::vector<AIPath> pathCache;
+
+	// new objects are connected directly to all nodes they reach, indirect connections are removed after
+	target->iterateNodes([this, &pathCache](const int3 & pos, const ObjectNode & node)
+		{
+			ai->pathfinder->calculatePathInfo(pathCache, pos);
+
+			for(AIPath & path : pathCache)
+			{
+				auto from = path.targetHero->visitablePos();
+
+				if(from == pos)
+					continue;
+
+				target->tryAddConnection(
+					from,
+					pos,
+					path.movementCost(),
+					ai->dangerEvaluator->evaluateDanger(pos, path.targetHero, true));
+
+				target->tryAddConnection(
+					pos,
+					from,
+					path.movementCost(),
+					ai->dangerEvaluator->evaluateDanger(from, path.targetHero, true));
+			}
+		});
+
+	removeExtraConnections();
+}
+
 float ObjectGraphCalculator::getNeighborConnectionsCost(const int3 & pos, std::vector<AIPath> & pathCache)
 {
 	float neighborCost = std::numeric_limits<float>::max();
@@ -255,15 +295,14 @@ void ObjectGraphCalculator::removeExtraConnections()
 	for(auto & actor : temporaryActorHeroes)
 	{
 		auto pos = actor->visitablePos();
-		auto & currentNode = target->getNode(pos);
 
-		target->iterateConnections(pos, [this, &pos, &connectionsToRemove, &currentNode](int3 n1, ObjectLink o1)
+		target->iterateConnections(pos, [this, &pos, &connectionsToRemove](int3 n1, ObjectLink o1)
 			{
-				target->iterateConnections(n1, [&pos, &o1, &currentNode, &connectionsToRemove, this](int3 n2, ObjectLink o2)
+				target->iterateConnections(n1, [&pos, &o1, &connectionsToRemove, this](int3 n2, ObjectLink o2)
 					{
-						auto direct = currentNode.connections.find(n2);
+						auto direct = target->getConnection(pos, n2);
 
-						if(direct != currentNode.connections.end() && isExtraConnection(direct->second.cost, o1.cost, o2.cost))
+						if(direct && isExtraConnection(direct->cost, o1.cost, o2.cost))
 						{
 							connectionsToRemove.push_back({pos, n2});
 						}
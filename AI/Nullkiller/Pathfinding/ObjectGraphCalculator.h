@@ -42,6 +42,8 @@ public:
 	void calculateConnections();
 	float getNeighborConnectionsCost(const int3 & pos, std::vector<AIPath> & pathCache);
 	void addMinimalDistanceJunctions();
+	/// Adds objects to graph which is already calculated connecting them to existing nodes
+	void connectObjects(const std::vector<const CGObjectInstance *> & objects);
 
 private:
 	void updatePaths();
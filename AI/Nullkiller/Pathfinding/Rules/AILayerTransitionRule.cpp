@@ -215,7 +215,7 @@ namespace AIPathfinding
 
 					if(castNode->action == EPathNodeAction::UNKNOWN)
 					{
-						castNode->addSpecialAction(specialAction);
+						nodeStorage->addSpecialAction(castNode, specialAction);
 						destination.blocked = false;
 						destination.action = targetAction;
 						destination.node = castNode;
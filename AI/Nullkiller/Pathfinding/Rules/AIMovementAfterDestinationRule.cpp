@@ -197,7 +197,7 @@ namespace AIPathfinding
 
 			nodeStorage->updateAINode(destination.node, [&](AIPathNode * node)
 			{
-				node->addSpecialAction(std::make_shared<QuestAction>(questAction));
+				nodeStorage->addSpecialAction(node, std::make_shared<QuestAction>(questAction));
 			});
 		}
 
@@ -333,7 +333,7 @@ namespace AIPathfinding
 
 			AIPreviousNodeRule(nodeStorage).process(source, destination, pathfinderConfig, pathfinderHelper);
 
-			battleNode->addSpecialAction(std::make_shared<BattleAction>(destination.coord));
+			nodeStorage->addSpecialAction(battleNode, std::make_shared<BattleAction>(destination.coord));
 
 #if NKAI_PATHFINDER_TRACE_LEVEL >= 1
 			logAi->trace(
@@ -361,6 +361,8 @@ void CServerHandler::sendClientConnecting() const
 	lcc.uuid = uuid;
 	lcc.names = localPlayerNames;
 	lcc.mode = si->mode;
+	lcc.compression = logicConnection->getPreferredCompression();
+	logicConnection->acceptCompression(lcc.compression);
 	sendLobbyPack(lcc);
 }
 
@@ -858,9 +860,15 @@ void CServerHandler::onPacketReceived(const std::shared_ptr<INetworkConnection>
 	if(getState() == EClientState::DISCONNECTING)
 		return;
 
-	auto pack = logicConnection->retrievePack(message);
-	ServerHandlerCPackVisitor visitor(*this);
-	pack->visit(visitor);
+	// Batch of packs is applied as a whole while holding interface lock
+	// Keep connection alive in case one of packs makes client disconnect
+	auto connection = logicConnection;
+	connection->retrievePacks(message, [this](std::unique_ptr<CPack> pack)
+	{
+		ServerHandlerCPackVisitor visitor(*this);
+		pack->visit(visitor);
+		return getState() != EClientState::DISCONNECTING;
+	});
 }
 
 void CServerHandler::onDisconnected(const std::shared_ptr<INetworkConnection> & connection, const std::string & errorMessage)
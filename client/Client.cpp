@@ -224,6 +224,7 @@ void CClient::initMapHandler()
 	}
 
 	pathCache.clear();
+	outdatedPathCache.clear();
 }
 
 void CClient::initPlayerEnvironments()
@@ -350,8 +351,8 @@ void CClient::installNewBattleInterface(std::shared_ptr<CBattleGameInterface> ba
 
 void CClient::handlePack(CPackForClient & pack)
 {
-	ApplyClientNetPackVisitor afterVisitor(*this, *gameState());
 	ApplyFirstClientNetPackVisitor beforeVisitor(*this, *gameState());
+	ApplyClientNetPackVisitor afterVisitor(*this, *gameState(), &beforeVisitor);
 
 	pack.visit(beforeVisitor);
 	logNetwork->trace("\tMade first apply on cl: %s", typeid(pack).name());
@@ -511,6 +512,23 @@ void CClient::invalidatePaths()
 {
 	boost::unique_lock<boost::mutex> pathLock(pathCacheMutex);
 	pathCache.clear();
+	outdatedPathCache.clear();
+}
+
+void CClient::invalidatePaths(const std::unordered_set<int3> & changedTiles)
+{
+	boost::unique_lock<boost::mutex> pathLock(pathCacheMutex);
+
+	for(auto & entry : pathCache)
+	{
+		// paths still referenced elsewhere can not be recalculated in place
+		if(entry.second.use_count() == 1)
+			outdatedPathCache[entry.first] = entry.second;
+	}
+	pathCache.clear();
+
+	for(auto & entry : outdatedPathCache)
+		entry.second->invalidateTiles(changedTiles);
 }
 
 vstd::RNG & CClient::getRandomGenerator()
@@ -529,9 +547,21 @@ std::shared_ptr<const CPathsInfo> CClient::getPathsInfo(const CGHeroInstance * h
 
 	if(iter == std::end(pathCache))
 	{
-		auto paths = std::make_shared<CPathsInfo>(getMapSize(), h);
+		std::shared_ptr<CPathsInfo> paths;
+		auto outdated = outdatedPathCache.find(h);
+
+		if(outdated != std::end(outdatedPathCache))
+		{
+			paths = outdated->second;
+			outdatedPathCache.erase(outdated);
+		}
+		else
+		{
+			paths = std::make_shared<CPathsInfo>(getMapSize(), h);
+		}
 
 		gs->calculatePaths(h, *paths.get());
+		logGlobal->trace("Calculated paths use %d bytes", paths->getMemoryUsage());
 
 		pathCache[h] = paths;
 		return paths;
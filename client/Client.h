@@ -150,6 +150,7 @@ public:
 	void startPlayerBattleAction(const BattleID & battleID, PlayerColor color);
 
 	void invalidatePaths(); // clears this->pathCache()
+	void invalidatePaths(const std::unordered_set<int3> & changedTiles); // marks cached paths as outdated, next request will only re-evaluate changed tiles
 	void updatePath(const ObjectInstanceID & heroID); // invalidatePaths and update displayed hero path 
 	void updatePath(const CGHeroInstance * hero);
 	std::shared_ptr<const CPathsInfo> getPathsInfo(const CGHeroInstance * h);
@@ -237,6 +238,7 @@ private:
 
 	mutable boost::mutex pathCacheMutex;
 	std::map<const CGHeroInstance *, std::shared_ptr<CPathsInfo>> pathCache;
+	std::map<const CGHeroInstance *, std::shared_ptr<CPathsInfo>> outdatedPathCache; // storage of paths that can be recalculated in place
 
 	void reinitScripting();
 };
@@ -12,6 +12,7 @@
 #include "../lib/networkPacks/NetPackVisitor.h"
 
 class CClient;
+class ApplyFirstClientNetPackVisitor;
 
 VCMI_LIB_NAMESPACE_BEGIN
 
@@ -24,10 +25,11 @@ class ApplyClientNetPackVisitor : public VCMI_LIB_WRAP_NAMESPACE(ICPackVisitor)
 private:
 	CClient & cl;
 	CGameState & gs;
+	const ApplyFirstClientNetPackVisitor * firstVisitor; // visitor that was applied to the same pack before game state, may be null
 
 public:
-	ApplyClientNetPackVisitor(CClient & cl, CGameState & gs)
-		:cl(cl), gs(gs)
+	ApplyClientNetPackVisitor(CClient & cl, CGameState & gs, const ApplyFirstClientNetPackVisitor * firstVisitor = nullptr)
+		:cl(cl), gs(gs), firstVisitor(firstVisitor)
 	{
 	}
 
@@ -70,6 +72,7 @@ public:
 	void visitGiveHero(GiveHero & pack) override;
 	void visitInfoWindow(InfoWindow & pack) override;
 	void visitSetObjectProperty(SetObjectProperty & pack) override;
+	void visitChangeObjectVisitors(ChangeObjectVisitors & pack) override;
 	void visitHeroLevelUp(HeroLevelUp & pack) override;
 	void visitCommanderLevelUp(CommanderLevelUp & pack) override;
 	void visitBlockingDialog(BlockingDialog & pack) override;
@@ -111,6 +114,7 @@ class ApplyFirstClientNetPackVisitor : public VCMI_LIB_WRAP_NAMESPACE(ICPackVisi
 private:
 	CClient & cl;
 	CGameState & gs;
+	std::unordered_set<int3> removedObjectTiles; //tiles affected by object that is being removed, empty if all paths must be invalidated
 
 public:
 	ApplyFirstClientNetPackVisitor(CClient & cl, CGameState & gs)
@@ -118,6 +122,8 @@ public:
 	{
 	}
 
+	const std::unordered_set<int3> & getRemovedObjectTiles() const { return removedObjectTiles; }
+
 	void visitChangeObjPos(ChangeObjPos & pack) override;
 	void visitRemoveObject(RemoveObject & pack) override;
 	void visitTryMoveHero(TryMoveHero & pack) override;
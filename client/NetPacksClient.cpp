@@ -383,6 +383,15 @@ void ApplyClientNetPackVisitor::visitNewTurn(NewTurn & pack)
 		std::string str = newWeek.text.toString();
 		callAllInterfaces(cl, &CGameInterface::showInfoDialog, newWeek.type, str, newWeek.components,(soundBase::soundID)newWeek.soundID);
 	}
+
+	// In auto testing mode game can be limited to specific number of days, e.g. for benchmarking
+	int benchmarkDays = settings["session"]["benchmarkDays"].Integer();
+	bool autoTesting = !settings["session"]["testmap"].isNull() || !settings["session"]["testsave"].isNull();
+	if(autoTesting && benchmarkDays > 0 && gs.getDate(Date::DAY) > benchmarkDays)
+	{
+		logAi->info("%d days have passed. Ending game.", benchmarkDays);
+		handleQuit(false);
+	}
 }
 
 void ApplyClientNetPackVisitor::visitGiveBonus(GiveBonus & pack)
@@ -508,6 +517,23 @@ void ApplyClientNetPackVisitor::visitRemoveBonus(RemoveBonus & pack)
 	}
 }
 
+/// Tiles which accessibility depends on the object, including neighbouring tiles it may guard
+static std::unordered_set<int3> getObjectAccessibilityTiles(const CGObjectInstance * o)
+{
+	std::unordered_set<int3> tiles;
+
+	for(const int3 & tile : o->getBlockedPos())
+		for(int dx = -1; dx <= 1; dx++)
+			for(int dy = -1; dy <= 1; dy++)
+				tiles.insert(tile + int3(dx, dy, 0));
+
+	for(int dx = -1; dx <= 1; dx++)
+		for(int dy = -1; dy <= 1; dy++)
+			tiles.insert(o->visitablePos() + int3(dx, dy, 0));
+
+	return tiles;
+}
+
 void ApplyFirstClientNetPackVisitor::visitRemoveObject(RemoveObject & pack)
 {
 	const CGObjectInstance *o = cl.getObj(pack.objectID);
@@ -524,13 +550,21 @@ void ApplyFirstClientNetPackVisitor::visitRemoveObject(RemoveObject & pack)
 			i->second->objectRemoved(o, pack.initiator);
 	}
 
+	// heroes are keys of path cache, so their removal always invalidates all paths
+	if(o->ID != Obj::HERO)
+		removedObjectTiles = getObjectAccessibilityTiles(o);
+
 	if(CGI->mh)
 		CGI->mh->waitForOngoingAnimations();
 }
 
 void ApplyClientNetPackVisitor::visitRemoveObject(RemoveObject & pack)
 {
-	cl.invalidatePaths();
+	if(!firstVisitor || firstVisitor->getRemovedObjectTiles().empty())
+		cl.invalidatePaths();
+	else
+		cl.invalidatePaths(firstVisitor->getRemovedObjectTiles());
+
 	for(auto i=cl.playerint.begin(); i!=cl.playerint.end(); i++)
 		i->second->objectRemovedAfter();
 }
@@ -560,7 +594,12 @@ void ApplyFirstClientNetPackVisitor::visitTryMoveHero(TryMoveHero & pack)
 void ApplyClientNetPackVisitor::visitTryMoveHero(TryMoveHero & pack)
 {
 	const CGHeroInstance *h = cl.getHero(pack.id);
-	cl.invalidatePaths();
+
+	// hero movement only changes accessibility of start and end tiles and of tiles revealed by hero
+	std::unordered_set<int3> changedTiles = pack.fowRevealed;
+	changedTiles.insert(h->convertToVisitablePos(pack.start));
+	changedTiles.insert(h->convertToVisitablePos(pack.end));
+	cl.invalidatePaths(changedTiles);
 
 	if(CGI->mh)
 	{
@@ -736,6 +775,21 @@ void ApplyClientNetPackVisitor::visitSetObjectProperty(SetObjectProperty & pack)
 		auto object = gs.getObjInstance(pack.id);
 		CGI->mh->onObjectInstantAdd(object, object->getOwner());
 	}
+
+	// passability of towns and garrisons depends on their owner
+	if(pack.what == ObjProperty::OWNER)
+		cl.invalidatePaths(getObjectAccessibilityTiles(gs.getObjInstance(pack.id)));
+}
+
+void ApplyClientNetPackVisitor::visitChangeObjectVisitors(ChangeObjectVisitors & pack)
+{
+	const CGObjectInstance * object = gs.getObjInstance(pack.object);
+
+	// visiting keymaster makes border gates of this color passable anywhere on map
+	if(!object || object->ID == Obj::KEYMASTER || pack.mode == ChangeObjectVisitors::VISITOR_GLOBAL)
+		cl.invalidatePaths();
+	else
+		cl.invalidatePaths(getObjectAccessibilityTiles(object));
 }
 
 void ApplyClientNetPackVisitor::visitHeroLevelUp(HeroLevelUp & pack)
@@ -48,6 +48,7 @@ void ApplyOnLobbyHandlerNetPackVisitor::visitLobbyClientConnected(LobbyClientCon
 	if(pack.uuid == handler.logicConnection->uuid)
 	{
 		handler.logicConnection->setSerializationVersion(pack.version);
+		handler.logicConnection->setCompression(pack.compression);
 		handler.logicConnection->connectionID = pack.clientId;
 		if(handler.mapToStart)
 		{
@@ -36,6 +36,7 @@
 
 #include "../lib/CThreadHelper.h"
 #include "../lib/ExceptionsCommon.h"
+#include "../lib/PerformanceStatistics.h"
 #include "../lib/filesystem/Filesystem.h"
 #include "../lib/logging/CBasicLogConfigurator.h"
 #include "../lib/texts/CGeneralTextHandler.h"
@@ -151,7 +152,10 @@ int main(int argc, char * argv[])
 		("nointro,i", "skips intro movies")
 		("donotstartserver,d","do not attempt to start server and just connect to it instead server")
 		("serverport", po::value<si64>(), "override port specified in config file")
-		("savefrequency", po::value<si64>(), "limit auto save creation to each N days");
+		("savefrequency", po::value<si64>(), "limit auto save creation to each N days")
+		("seed", po::value<si64>(), "random seed for new game, overrides seed from settings")
+		("benchmark", po::value<std::string>(), "record performance statistics and write them in JSON format to specified file on exit")
+		("benchmark-days", po::value<si64>(), "end game started with --testmap or --testsave after specified number of days");
 
 	if(argc > 1)
 	{
@@ -259,6 +263,10 @@ int main(int argc, char * argv[])
 	// Init special testing settings
 	setSettingInteger("session/serverport", "serverport", 0);
 	setSettingInteger("general/saveFrequency", "savefrequency", 1);
+	setSettingInteger("session/seed", "seed", 0);
+	setSettingInteger("session/benchmarkDays", "benchmark-days", 0);
+	if(vm.count("benchmark"))
+		session["benchmark"].String() = vm["benchmark"].as<std::string>();
 
 	// Initialize logging based on settings
 	logConfig->configure();
@@ -357,7 +365,10 @@ int main(int argc, char * argv[])
 	session["autoSkip"].Bool()  = vm.count("autoSkip");
 	session["oneGoodAI"].Bool() = vm.count("oneGoodAI");
 	session["aiSolo"].Bool() = false;
-	
+
+	if(vm.count("benchmark"))
+		PerformanceStatistics::getInstance().enable();
+
 	if(vm.count("testmap"))
 	{
 		session["testmap"].String() = vm["testmap"].as<std::string>();
@@ -429,8 +440,21 @@ static void mainLoop()
 #endif
 }
 
+static void writeBenchmarkReport()
+{
+	const auto & reportPath = settings["session"]["benchmark"];
+	if(reportPath.isNull())
+		return;
+
+	logGlobal->info("Writing benchmark report to %s", reportPath.String());
+	std::ofstream file(reportPath.String());
+	file << PerformanceStatistics::getInstance().toJson().toString();
+}
+
 [[noreturn]] static void quitApplication()
 {
+	writeBenchmarkReport();
+
 	CSH->endNetwork();
 
 	if(!settings["session"]["headless"].Bool())
@@ -0,0 +1,109 @@
+/*
+ * PerformanceStatistics.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "PerformanceStatistics.h"
+
+#include "json/JsonNode.h"
+
+#ifdef VCMI_WINDOWS
+	#include <windows.h>
+	#include <psapi.h>
+#elif defined(VCMI_UNIX)
+	#include <sys/resource.h>
+#endif
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+PerformanceStatistics & PerformanceStatistics::getInstance()
+{
+	static PerformanceStatistics instance;
+	return instance;
+}
+
+void PerformanceStatistics::enable()
+{
+	std::lock_guard lock(dataMutex);
+	sections.clear();
+	counters.clear();
+	enableTime = std::chrono::steady_clock::now();
+	enabled = true;
+}
+
+void PerformanceStatistics::addTime(const char * section, std::chrono::nanoseconds duration)
+{
+	if(!isEnabled())
+		return;
+
+	std::lock_guard lock(dataMutex);
+	auto & timing = sections[section];
+	timing.count += 1;
+	timing.total += duration;
+	timing.longest = std::max(timing.longest, duration);
+}
+
+void PerformanceStatistics::addCount(const char * counter, int64_t amount)
+{
+	if(!isEnabled())
+		return;
+
+	std::lock_guard lock(dataMutex);
+	counters[counter] += amount;
+}
+
+int64_t PerformanceStatistics::getPeakMemoryUsage()
+{
+#if defined(VCMI_WINDOWS)
+	PROCESS_MEMORY_COUNTERS counters;
+	if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize / 1024;
+	return 0;
+#elif defined(VCMI_APPLE)
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss / 1024; // reported in bytes
+#elif defined(VCMI_UNIX)
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss; // reported in kilobytes
+#else
+	return 0;
+#endif
+}
+
+JsonNode PerformanceStatistics::toJson() const
+{
+	auto toMilliseconds = [](std::chrono::nanoseconds duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	};
+
+	std::lock_guard lock(dataMutex);
+	JsonNode result;
+
+	for(const auto & [name, timing] : sections)
+	{
+		JsonNode & entry = result["sections"][name];
+		entry["count"].Integer() = timing.count;
+		entry["totalMs"].Float() = toMilliseconds(timing.total);
+		entry["averageMs"].Float() = toMilliseconds(timing.total) / timing.count;
+		entry["longestMs"].Float() = toMilliseconds(timing.longest);
+	}
+
+	for(const auto & [name, value] : counters)
+		result["counters"][name].Integer() = value;
+
+	if(isEnabled())
+		result["wallTimeMs"].Float() = toMilliseconds(std::chrono::steady_clock::now() - enableTime);
+	result["peakMemoryKB"].Integer() = getPeakMemoryUsage();
+
+	return result;
+}
+
+VCMI_LIB_NAMESPACE_END
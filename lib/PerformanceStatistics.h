@@ -0,0 +1,78 @@
+/*
+ * PerformanceStatistics.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+class JsonNode;
+
+/// Collects timings of named code sections and event counters for benchmarking
+/// Disabled by default, in which case measurements are not recorded and have negligible cost
+class DLL_LINKAGE PerformanceStatistics : boost::noncopyable
+{
+	struct SectionTiming
+	{
+		int64_t count = 0;
+		std::chrono::nanoseconds total{0};
+		std::chrono::nanoseconds longest{0};
+	};
+
+	std::atomic<bool> enabled = false;
+	std::chrono::steady_clock::time_point enableTime;
+
+	mutable std::mutex dataMutex;
+	std::map<std::string, SectionTiming> sections;
+	std::map<std::string, int64_t> counters;
+
+	PerformanceStatistics() = default;
+
+public:
+	static PerformanceStatistics & getInstance();
+
+	bool isEnabled() const
+	{
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	/// Starts recording of measurements, discarding any previously recorded data
+	void enable();
+
+	void addTime(const char * section, std::chrono::nanoseconds duration);
+	void addCount(const char * counter, int64_t amount = 1);
+
+	/// Returns peak resident memory usage of this process in kilobytes, or 0 if not supported by platform
+	static int64_t getPeakMemoryUsage();
+
+	/// Returns all recorded data along with wall time since recording start and peak memory usage
+	JsonNode toJson() const;
+};
+
+/// Measures time between construction and destruction and records it under specified section name
+class PerformanceTimer : boost::noncopyable
+{
+	const char * section;
+	std::chrono::steady_clock::time_point start;
+
+public:
+	explicit PerformanceTimer(const char * section)
+		: section(PerformanceStatistics::getInstance().isEnabled() ? section : nullptr)
+	{
+		if(this->section)
+			start = std::chrono::steady_clock::now();
+	}
+
+	~PerformanceTimer()
+	{
+		if(section)
+			PerformanceStatistics::getInstance().addTime(section, std::chrono::steady_clock::now() - start);
+	}
+};
+
+VCMI_LIB_NAMESPACE_END
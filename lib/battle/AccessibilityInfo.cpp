@@ -21,11 +21,7 @@ bool AccessibilityInfo::tileAccessibleWithGate(BattleHex tile, BattleSide side)
 	auto accessibility = at(tile);
 
 	if(accessibility == EAccessibility::ALIVE_STACK)
-	{
-		auto destructible = destructibleEnemyTurns.find(tile);
-
-		return destructible != destructibleEnemyTurns.end();
-	}
+		return destructibleEnemyTurns.contains(tile);
 
 	if(accessibility != EAccessibility::ACCESSIBLE)
 		if(accessibility != EAccessibility::GATE || side != BattleSide::DEFENDER)
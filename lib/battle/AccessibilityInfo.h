@@ -19,7 +19,7 @@ namespace battle
 }
 
 //Accessibility is property of hex in battle. It doesn't depend on stack, side's perspective and so on.
-enum class EAccessibility
+enum class EAccessibility : ui8
 {
 	ACCESSIBLE,
 	ALIVE_STACK,
@@ -33,9 +33,38 @@ enum class EAccessibility
 
 using TAccessibilityArray = std::array<EAccessibility, GameConstants::BFIELD_SIZE>;
 
+/// How many turns it is needed to kill enemy on specific hex, flat table indexed by hex
+class DestructibleEnemyTurns
+{
+	BattleHexBitset hexes;
+	std::array<ui8, GameConstants::BFIELD_SIZE> turns{};
+
+public:
+	bool contains(BattleHex hex) const
+	{
+		return hex.isValid() && hexes.test(hex.hex);
+	}
+
+	ui8 get(BattleHex hex) const
+	{
+		return contains(hex) ? turns[hex.hex] : 0;
+	}
+
+	void set(BattleHex hex, ui8 value)
+	{
+		hexes.set(hex.hex);
+		turns[hex.hex] = value;
+	}
+
+	bool empty() const
+	{
+		return hexes.none();
+	}
+};
+
 struct DLL_LINKAGE AccessibilityInfo : TAccessibilityArray
 {
-	std::map<BattleHex, ui8> destructibleEnemyTurns;
+	DestructibleEnemyTurns destructibleEnemyTurns;
 
 	public:
 		bool accessible(BattleHex tile, const battle::Unit * stack) const; //checks for both tiles if stack is double wide
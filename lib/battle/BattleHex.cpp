@@ -136,8 +136,22 @@ std::vector<BattleHex> BattleHex::neighbouringTiles() const
 {
 	std::vector<BattleHex> ret;
 	ret.reserve(6);
-	for(auto dir : hexagonalDirections())
-		checkAndPush(cloneInDirection(dir, false), ret);
+
+	if(!isValid())
+	{
+		for(auto dir : hexagonalDirections())
+			checkAndPush(cloneInDirection(dir, false), ret);
+		return ret;
+	}
+
+	for(si16 neighbour : neighbouringTilesCache[hex])
+	{
+		if(neighbour < 0)
+			break;
+
+		ret.emplace_back(neighbour);
+	}
+
 	return ret;
 }
 
@@ -223,23 +237,4 @@ std::ostream & operator<<(std::ostream & os, const BattleHex & hex)
 	return os << boost::str(boost::format("{BattleHex: x '%d', y '%d', hex '%d'}") % hex.getX() % hex.getY() % hex.hex);
 }
 
-static BattleHex::NeighbouringTilesCache calculateNeighbouringTiles()
-{
-	BattleHex::NeighbouringTilesCache ret;
-	ret.resize(GameConstants::BFIELD_SIZE);
-
-	for(si16 hex = 0; hex < GameConstants::BFIELD_SIZE; hex++)
-	{
-		auto hexes = BattleHex(hex).neighbouringTiles();
-
-		size_t index = 0;
-		for(auto neighbour : hexes)
-			ret[hex].at(index++) = neighbour;
-	}
-
-	return ret;
-}
-
-const BattleHex::NeighbouringTilesCache BattleHex::neighbouringTilesCache = calculateNeighbouringTiles();
-
 VCMI_LIB_NAMESPACE_END
@@ -22,6 +22,48 @@ namespace GameConstants
 	const int BFIELD_SIZE = BFIELD_WIDTH * BFIELD_HEIGHT;
 }
 
+/// Set of battlefield hexes, indexed by hex number
+using BattleHexBitset = std::bitset<GameConstants::BFIELD_SIZE>;
+
+namespace BattleHexTables
+{
+	using NeighbouringTiles = std::array<si16, 6>;
+	using NeighbouringTilesTable = std::array<NeighbouringTiles, GameConstants::BFIELD_SIZE>;
+
+	/// Available neighbours of each hex in EDir order, unused elements are set to -1
+	constexpr NeighbouringTilesTable calculateNeighbouringTiles()
+	{
+		NeighbouringTilesTable ret{};
+
+		for(int hex = 0; hex < GameConstants::BFIELD_SIZE; hex++)
+		{
+			const int x = hex % GameConstants::BFIELD_WIDTH;
+			const int y = hex / GameConstants::BFIELD_WIDTH;
+			const int shift = y % 2;
+
+			// TOP_LEFT, TOP_RIGHT, RIGHT, BOTTOM_RIGHT, BOTTOM_LEFT, LEFT
+			const int neighbourX[6] = {x - shift, x + 1 - shift, x + 1, x + 1 - shift, x - shift, x - 1};
+			const int neighbourY[6] = {y - 1, y - 1, y, y + 1, y + 1, y};
+
+			size_t index = 0;
+
+			for(int dir = 0; dir < 6; dir++)
+			{
+				ret[hex][dir] = -1;
+
+				// side columns are not available for movement
+				if(neighbourX[dir] > 0 && neighbourX[dir] < GameConstants::BFIELD_WIDTH - 1
+					&& neighbourY[dir] >= 0 && neighbourY[dir] < GameConstants::BFIELD_HEIGHT)
+				{
+					ret[hex][index++] = static_cast<si16>(neighbourX[dir] + neighbourY[dir] * GameConstants::BFIELD_WIDTH);
+				}
+			}
+		}
+
+		return ret;
+	}
+}
+
 // for battle stacks' positions
 struct DLL_LINKAGE BattleHex //TODO: decide if this should be changed to class for better code design
 {
@@ -101,10 +143,11 @@ struct DLL_LINKAGE BattleHex //TODO: decide if this should be changed to class f
 		h & hex;
 	}
 
-    using NeighbouringTiles = std::array<BattleHex, 6>;
-    using NeighbouringTilesCache = std::vector<NeighbouringTiles>;
+	using NeighbouringTiles = BattleHexTables::NeighbouringTiles;
+	using NeighbouringTilesCache = BattleHexTables::NeighbouringTilesTable;
 
-    static const NeighbouringTilesCache neighbouringTilesCache;
+	/// Compile-time table of available neighbours, see neighbouringTiles()
+	static constexpr NeighbouringTilesCache neighbouringTilesCache = BattleHexTables::calculateNeighbouringTiles();
 private:
 	//Constexpr defined array with all directions used in battle
 	static constexpr auto hexagonalDirections() {
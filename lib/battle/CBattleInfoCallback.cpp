@@ -1071,54 +1071,81 @@ ReachabilityInfo CBattleInfoCallback::makeBFS(const AccessibilityInfo &accessibi
 	if(!params.startPosition.isValid()) //if got call for arrow turrets
 		return ret;
 
-	const std::set<BattleHex> obstacles = getStoppers(params.perspective);
-	auto checkParams = params;
-	checkParams.ignoreKnownAccessible = true; //Ignore starting hexes obstacles
+	// hexes that walking stack can't step past, same rules as in isInObstacle with ignored known accessible hexes
+	BattleHexBitset stoppers;
+	const bool gateBlocks = params.side == BattleSide::ATTACKER && battleGetGateState() != EGateState::DESTROYED;
 
-	std::queue<BattleHex> hexq; //bfs queue
+	for(auto hex : getStoppers(params.perspective))
+	{
+		if(hex.isValid() && (hex != BattleHex::GATE_BRIDGE || gateBlocks))
+			stoppers.set(hex.hex);
+	}
 
-	//first element
-	hexq.push(params.startPosition);
-	ret.distances[params.startPosition] = 0;
+	for(auto hex : params.knownAccessible)
+	{
+		if(hex.isValid())
+			stoppers.reset(hex.hex);
+	}
 
-	std::array<bool, GameConstants::BFIELD_SIZE> accessibleCache{};
+	BattleHexBitset accessibleHexes;
 	for(int hex = 0; hex < GameConstants::BFIELD_SIZE; hex++)
-		accessibleCache[hex] = accessibility.accessible(hex, params.doubleWide, params.side);
+		accessibleHexes[hex] = accessibility.accessible(hex, params.doubleWide, params.side);
+
+	// every hex is queued at most once at a time, so ring buffer of battlefield size is enough
+	std::array<BattleHex, GameConstants::BFIELD_SIZE> hexq; //bfs queue
+	BattleHexBitset queued;
+	size_t queueHead = 0;
+	size_t queueSize = 0;
+
+	//first element
+	hexq[0] = params.startPosition;
+	queueSize = 1;
+	queued.set(params.startPosition.hex);
+	ret.distances[params.startPosition] = 0;
 
-	while(!hexq.empty()) //bfs loop
+	while(queueSize) //bfs loop
 	{
-		const BattleHex curHex = hexq.front();
-		hexq.pop();
+		const BattleHex curHex = hexq[queueHead];
+		queueHead = (queueHead + 1) % GameConstants::BFIELD_SIZE;
+		queueSize--;
+		queued.reset(curHex.hex);
 
 		//walking stack can't step past the obstacles
-		if(isInObstacle(curHex, obstacles, checkParams))
+		if(stoppers.test(curHex.hex))
 			continue;
 
-		const int costToNeighbour = ret.distances.at(curHex.hex) + 1;
+		if(params.doubleWide)
+		{
+			auto otherHex = battle::Unit::occupiedHex(curHex, params.doubleWide, params.side);
 
-		for(BattleHex neighbour : BattleHex::neighbouringTilesCache[curHex.hex])
+			if(otherHex.isValid() && stoppers.test(otherHex.hex))
+				continue;
+		}
+
+		const int costToNeighbour = ret.distances[curHex.hex] + 1;
+
+		for(si16 neighbour : BattleHex::neighbouringTilesCache[curHex.hex])
 		{
-			if(neighbour.isValid())
-			{
-				auto additionalCost = 0;
+			if(neighbour < 0)
+				break;
 
-				if(params.bypassEnemyStacks)
-				{
-					auto enemyToBypass = params.destructibleEnemyTurns.find(neighbour);
+			if(!accessibleHexes.test(neighbour))
+				continue;
 
-					if(enemyToBypass != params.destructibleEnemyTurns.end())
-					{
-						additionalCost = enemyToBypass->second;
-					}
-				}
+			const int additionalCost = params.bypassEnemyStacks ? params.destructibleEnemyTurns.get(neighbour) : 0;
+			const int costFoundSoFar = ret.distances[neighbour];
 
-				const int costFoundSoFar = ret.distances[neighbour.hex];
+			if(costToNeighbour + additionalCost < costFoundSoFar)
+			{
+				ret.distances[neighbour] = costToNeighbour + additionalCost;
+				ret.predecessors[neighbour] = curHex;
 
-				if(accessibleCache[neighbour.hex] && costToNeighbour + additionalCost < costFoundSoFar)
+				// queued hex is expanded with updated distance when popped
+				if(!queued.test(neighbour))
 				{
-					hexq.push(neighbour);
-					ret.distances[neighbour.hex] = costToNeighbour + additionalCost;
-					ret.predecessors[neighbour.hex] = curHex;
+					hexq[(queueHead + queueSize) % GameConstants::BFIELD_SIZE] = neighbour;
+					queueSize++;
+					queued.set(neighbour);
 				}
 			}
 		}
@@ -1788,10 +1815,7 @@ SpellID CBattleInfoCallback::getRandomBeneficialSpell(vstd::RNG & rand, const ba
 
 	for(const SpellID& spellID : allPossibleSpells)
 	{
-		std::stringstream cachingStr;
-		cachingStr << "source_" << vstd::to_underlying(BonusSource::SPELL_EFFECT) << "id_" << spellID.num;
-
-		if(subject->hasBonus(Selector::source(BonusSource::SPELL_EFFECT, BonusSourceID(spellID)), Selector::all, cachingStr.str()))
+		if(subject->hasBonus(Selector::source(BonusSource::SPELL_EFFECT, BonusSourceID(spellID)), Selector::all))
 			continue;
 
 		auto spellPtr = spellID.toSpell();
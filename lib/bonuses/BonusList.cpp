@@ -14,34 +14,41 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
-BonusList::BonusList(bool BelongsToTree) : belongsToTree(BelongsToTree)
+BonusList::BonusList(const CBonusSystemNode * Owner) : owner(Owner)
 {
 }
 
-BonusList::BonusList(const BonusList & bonusList): belongsToTree(false)
+BonusList::BonusList(const BonusList & bonusList): owner(nullptr)
 {
 	bonuses.resize(bonusList.size());
 	std::copy(bonusList.begin(), bonusList.end(), bonuses.begin());
 }
 
-BonusList::BonusList(BonusList && other) noexcept: belongsToTree(false)
+BonusList::BonusList(BonusList && other) noexcept: owner(nullptr)
 {
-	std::swap(belongsToTree, other.belongsToTree);
+	std::swap(owner, other.owner);
 	std::swap(bonuses, other.bonuses);
+	std::swap(typeIndex, other.typeIndex);
+	std::swap(typeOffsets, other.typeOffsets);
 }
 
 BonusList& BonusList::operator=(const BonusList &bonusList)
 {
 	bonuses.resize(bonusList.size());
 	std::copy(bonusList.begin(), bonusList.end(), bonuses.begin());
-	belongsToTree = false;
+	typeIndex.clear();
+	typeOffsets.clear();
+	owner = nullptr;
 	return *this;
 }
 
-void BonusList::changed() const
+void BonusList::changed()
 {
-    if(belongsToTree)
-		CBonusSystemNode::treeHasChanged();
+	typeIndex.clear();
+	typeOffsets.clear();
+
+	if(owner)
+		owner->nodeHasChanged();
 }
 
 void BonusList::stackBonuses()
@@ -81,6 +88,34 @@ void BonusList::stackBonuses()
 		else
 			next++;
 	}
+	typeIndex.clear();
+	typeOffsets.clear();
+}
+
+void BonusList::buildTypeIndex()
+{
+	typeIndex.clear();
+	typeOffsets.clear();
+
+	if(bonuses.empty())
+		return;
+
+	size_t typesCount = 0;
+	for(const auto & b : bonuses)
+		vstd::amax(typesCount, vstd::to_underlying(b->type) + 1);
+
+	// counting sort - keeps original order of bonuses within each type
+	typeOffsets.resize(typesCount + 1, 0);
+	for(const auto & b : bonuses)
+		typeOffsets[vstd::to_underlying(b->type) + 1]++;
+
+	for(size_t i = 1; i < typeOffsets.size(); ++i)
+		typeOffsets[i] += typeOffsets[i - 1];
+
+	std::vector<uint32_t> insertPosition(typeOffsets.begin(), typeOffsets.end() - 1);
+	typeIndex.resize(bonuses.size());
+	for(uint32_t i = 0; i < bonuses.size(); ++i)
+		typeIndex[insertPosition[vstd::to_underlying(bonuses[i]->type)]++] = i;
 }
 
 int BonusList::totalValue() const
@@ -195,6 +230,23 @@ std::shared_ptr<const Bonus> BonusList::getFirst(const CSelector &selector) cons
 
 void BonusList::getBonuses(BonusList & out, const CSelector &selector, const CSelector &limit) const
 {
+	const auto & key = selector.getKey();
+	if(!typeOffsets.empty() && key && (key->fields & BonusSelectorKey::TYPE))
+	{
+		// only bonuses of selected type need to be checked
+		size_t typeID = vstd::to_underlying(key->type);
+		if(typeID + 1 >= typeOffsets.size())
+			return;
+
+		for(size_t i = typeOffsets[typeID]; i < typeOffsets[typeID + 1]; ++i)
+		{
+			const auto & b = bonuses[typeIndex[i]];
+			if(selector(b.get()) && (!limit || limit(b.get())))
+				out.push_back(b);
+		}
+		return;
+	}
+
 	out.reserve(bonuses.size());
 	for(const auto & b : bonuses)
 	{
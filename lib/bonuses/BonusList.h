@@ -21,8 +21,13 @@ public:
 
 private:
 	TInternalContainer bonuses;
-	bool belongsToTree;
-	void changed() const;
+	const CBonusSystemNode * owner; // node whose bonus tree this list belongs to, if any
+
+	// Optional index of bonuses grouped by type, see buildTypeIndex()
+	std::vector<uint32_t> typeIndex; // positions of all bonuses in list, ordered by bonus type
+	std::vector<uint32_t> typeOffsets; // for each bonus type - offset of its first entry in typeIndex
+
+	void changed();
 
 public:
 	using const_reference = TInternalContainer::const_reference;
@@ -31,7 +36,7 @@ public:
 	using const_iterator = TInternalContainer::const_iterator;
 	using iterator = TInternalContainer::iterator;
 
-	BonusList(bool BelongsToTree = false);
+	BonusList(const CBonusSystemNode * Owner = nullptr);
 	BonusList(const BonusList &bonusList);
 	BonusList(BonusList && other) noexcept;
 	BonusList& operator=(const BonusList &bonusList);
@@ -59,6 +64,10 @@ public:
 
 	// BonusList functions
 	void stackBonuses();
+
+	/// Groups bonuses by type, so selection of bonuses of specific type only checks bonuses of this type
+	/// Index is dropped on any modification of the list and must be built again afterwards
+	void buildTypeIndex();
 	int totalValue() const;
 	void getBonuses(BonusList &out, const CSelector &selector, const CSelector &limit = nullptr) const;
 	void getAllBonuses(BonusList &out) const;
@@ -81,6 +90,8 @@ public:
 			if (!pred(b.get()))
 				newList.push_back(b);
 		}
+		typeIndex.clear();
+		typeOffsets.clear();
 		bonuses.clear();
 		bonuses.resize(newList.size());
 		std::copy(newList.begin(), newList.end(), bonuses.begin());
@@ -13,6 +13,48 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+std::optional<BonusSelectorKey> BonusSelectorKey::combine(const BonusSelectorKey & lhs, const BonusSelectorKey & rhs)
+{
+	if(lhs.fields & rhs.fields)
+		return std::nullopt;
+
+	BonusSelectorKey result = lhs;
+	result.fields |= rhs.fields;
+	if(rhs.fields & TYPE)
+		result.type = rhs.type;
+	if(rhs.fields & SUBTYPE)
+		result.subtype = rhs.subtype;
+	if(rhs.fields & SOURCE)
+		result.source = rhs.source;
+	if(rhs.fields & SOURCE_ID)
+		result.sid = rhs.sid;
+	if(rhs.fields & VALUE_TYPE)
+		result.valType = rhs.valType;
+	return result;
+}
+
+bool BonusSelectorKey::operator==(const BonusSelectorKey & other) const
+{
+	// fields that are not part of key always have default values, so they can be compared as well
+	return fields == other.fields
+		&& type == other.type
+		&& subtype == other.subtype
+		&& source == other.source
+		&& sid == other.sid
+		&& valType == other.valType;
+}
+
+size_t BonusSelectorKey::Hash::operator()(const BonusSelectorKey & key) const
+{
+	size_t result = key.fields;
+	vstd::hash_combine(result, static_cast<int>(key.type));
+	vstd::hash_combine(result, key.subtype.getNum());
+	vstd::hash_combine(result, static_cast<int>(key.source));
+	vstd::hash_combine(result, key.sid.getNum());
+	vstd::hash_combine(result, static_cast<int>(key.valType));
+	return result;
+}
+
 namespace Selector
 {
 	DLL_LINKAGE const CSelectFieldEqual<BonusType> & type()
@@ -96,7 +138,7 @@ namespace Selector
 				.And(valueType(valType));
 	}
 
-	DLL_LINKAGE CSelector all([](const Bonus * b){return true;});
+	DLL_LINKAGE CSelector all = CSelector([](const Bonus * b){return true;}).withKey(BonusSelectorKey());
 	DLL_LINKAGE CSelector none([](const Bonus * b){return false;});
 }
 
@@ -14,9 +14,87 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+/// Structural description of selector that only compares bonus fields against fixed values.
+/// Unlike selector itself, such key can be compared and hashed, which allows caching of selection results
+class DLL_LINKAGE BonusSelectorKey
+{
+public:
+	enum EField : uint8_t
+	{
+		TYPE = 1,
+		SUBTYPE = 2,
+		SOURCE = 4,
+		SOURCE_ID = 8,
+		VALUE_TYPE = 16
+	};
+
+	uint8_t fields = 0; // bitmask of EField, key without fields selects all bonuses
+	BonusType type = BonusType::NONE;
+	BonusSubtypeID subtype;
+	BonusSource source = BonusSource::OTHER;
+	BonusSourceID sid;
+	BonusValueType valType = BonusValueType::ADDITIVE_VALUE;
+
+	/// Returns key for selector that compares bonus field with specified value, if such field is supported
+	template<typename T>
+	static std::optional<BonusSelectorKey> forField(T Bonus::*ptr, const T & value)
+	{
+		BonusSelectorKey key;
+		if constexpr(std::is_same_v<T, BonusType>)
+		{
+			if(ptr == &Bonus::type)
+				key.set(TYPE, &BonusSelectorKey::type, value);
+		}
+		if constexpr(std::is_same_v<T, BonusSubtypeID>)
+		{
+			if(ptr == &Bonus::subtype)
+				key.set(SUBTYPE, &BonusSelectorKey::subtype, value);
+		}
+		if constexpr(std::is_same_v<T, BonusSource>)
+		{
+			if(ptr == &Bonus::source)
+				key.set(SOURCE, &BonusSelectorKey::source, value);
+		}
+		if constexpr(std::is_same_v<T, BonusSourceID>)
+		{
+			if(ptr == &Bonus::sid)
+				key.set(SOURCE_ID, &BonusSelectorKey::sid, value);
+		}
+		if constexpr(std::is_same_v<T, BonusValueType>)
+		{
+			if(ptr == &Bonus::valType)
+				key.set(VALUE_TYPE, &BonusSelectorKey::valType, value);
+		}
+
+		if(key.fields == 0)
+			return std::nullopt;
+		return key;
+	}
+
+	/// Returns key that selects bonuses matching both keys, or nothing if keys restrict same field
+	static std::optional<BonusSelectorKey> combine(const BonusSelectorKey & lhs, const BonusSelectorKey & rhs);
+
+	bool operator==(const BonusSelectorKey & other) const;
+
+	struct Hash
+	{
+		size_t operator()(const BonusSelectorKey & key) const;
+	};
+
+private:
+	template<typename T>
+	void set(EField field, T BonusSelectorKey::*member, const T & value)
+	{
+		fields |= field;
+		this->*member = value;
+	}
+};
+
 class CSelector : std::function<bool(const Bonus*)>
 {
 	using TBase = std::function<bool(const Bonus*)>;
+
+	std::optional<BonusSelectorKey> key;
 public:
 	CSelector() = default;
 	template<typename T>
@@ -33,7 +111,10 @@ public:
 	{
 		//lambda may likely outlive "this" (it can be even a temporary) => we copy the OBJECT (not pointer)
 		auto thisCopy = *this;
-		return [thisCopy, rhs](const Bonus *b) mutable { return thisCopy(b) && rhs(b); };
+		CSelector result = [thisCopy, rhs](const Bonus *b) mutable { return thisCopy(b) && rhs(b); };
+		if(key && rhs.key)
+			result.key = BonusSelectorKey::combine(*key, *rhs.key);
+		return result;
 	}
 	CSelector Or(CSelector rhs) const
 	{
@@ -56,6 +137,26 @@ public:
 	{
 		return !!static_cast<const TBase&>(*this);
 	}
+
+	/// Returns copy of this selector with attached structural key. Key must describe exactly same selection
+	CSelector withKey(const std::optional<BonusSelectorKey> & newKey) const
+	{
+		CSelector result = *this;
+		result.key = newKey;
+		return result;
+	}
+
+	/// Returns structural key of this selector, if it is known
+	const std::optional<BonusSelectorKey> & getKey() const
+	{
+		return key;
+	}
+
+	/// Returns true if this selector is known to accept any bonus
+	bool selectsAll() const
+	{
+		return key && key->fields == 0;
+	}
 };
 
 template<typename T>
@@ -72,10 +173,11 @@ public:
 	CSelector operator()(const T &valueToCompareAgainst) const
 	{
 		auto ptr2 = ptr; //We need a COPY because we don't want to reference this (might be outlived by lambda)
-		return [ptr2, valueToCompareAgainst](const Bonus *bonus)
+		CSelector result = [ptr2, valueToCompareAgainst](const Bonus *bonus)
 		{
 			return bonus->*ptr2 == valueToCompareAgainst;
 		};
+		return result.withKey(BonusSelectorKey::forField(ptr2, valueToCompareAgainst));
 	}
 };
 
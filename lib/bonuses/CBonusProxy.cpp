@@ -115,26 +115,60 @@ CTotalsProxy::CTotalsProxy(const IBonusBearer * Target, CSelector Selector, int
 
 CTotalsProxy::CTotalsProxy(const CTotalsProxy & other)
 	: CBonusProxy(other),
-	initialValue(other.initialValue),
-	meleeCachedLast(other.meleeCachedLast),
-	meleeValue(other.meleeValue),
-	rangedCachedLast(other.rangedCachedLast),
-	rangedValue(other.rangedValue)
+	initialValue(other.initialValue)
 {
+	boost::lock_guard<boost::mutex> lock(other.cacheGuard);
+
+	valueCachedLast = other.valueCachedLast;
+	value = other.value;
+	meleeCachedLast = other.meleeCachedLast;
+	meleeValue = other.meleeValue;
+	rangedCachedLast = other.rangedCachedLast;
+	rangedValue = other.rangedValue;
+}
+
+CTotalsProxy & CTotalsProxy::operator=(const CTotalsProxy & other)
+{
+	if(this == &other)
+		return *this;
+
+	CBonusProxy::operator=(other);
+	initialValue = other.initialValue;
+
+	std::lock(cacheGuard, other.cacheGuard);
+	boost::lock_guard<boost::mutex> lock(cacheGuard, boost::adopt_lock);
+	boost::lock_guard<boost::mutex> otherLock(other.cacheGuard, boost::adopt_lock);
+
+	valueCachedLast = other.valueCachedLast;
+	value = other.value;
+	meleeCachedLast = other.meleeCachedLast;
+	meleeValue = other.meleeValue;
+	rangedCachedLast = other.rangedCachedLast;
+	rangedValue = other.rangedValue;
+
+	return *this;
 }
 
 int CTotalsProxy::getValue() const
 {
 	const auto treeVersion = target->getTreeVersion();
 
-	if(treeVersion != valueCachedLast)
 	{
-		auto bonuses = getBonusList();
+		boost::lock_guard<boost::mutex> lock(cacheGuard);
 
-		value = initialValue + bonuses->totalValue();
-		valueCachedLast = treeVersion;
+		if(treeVersion == valueCachedLast)
+			return value;
 	}
-	return value;
+
+	// bonuses are collected without holding the lock, concurrent readers of same version calculate same value
+	auto bonuses = getBonusList();
+	const int newValue = initialValue + bonuses->totalValue();
+
+	boost::lock_guard<boost::mutex> lock(cacheGuard);
+
+	value = newValue;
+	valueCachedLast = treeVersion;
+	return newValue;
 }
 
 int CTotalsProxy::getValueAndList(TConstBonusListPtr & outBonusList) const
@@ -142,12 +176,20 @@ int CTotalsProxy::getValueAndList(TConstBonusListPtr & outBonusList) const
 	const auto treeVersion = target->getTreeVersion();
 	outBonusList = getBonusList();
 
-	if(treeVersion != valueCachedLast)
 	{
-		value = initialValue + outBonusList->totalValue();
-		valueCachedLast = treeVersion;
+		boost::lock_guard<boost::mutex> lock(cacheGuard);
+
+		if(treeVersion == valueCachedLast)
+			return value;
 	}
-	return value;
+
+	const int newValue = initialValue + outBonusList->totalValue();
+
+	boost::lock_guard<boost::mutex> lock(cacheGuard);
+
+	value = newValue;
+	valueCachedLast = treeVersion;
+	return newValue;
 }
 
 int CTotalsProxy::getMeleeValue() const
@@ -156,14 +198,21 @@ int CTotalsProxy::getMeleeValue() const
 
 	const auto treeVersion = target->getTreeVersion();
 
-	if(treeVersion != meleeCachedLast)
 	{
-		auto bonuses = target->getBonuses(selector, limit);
-		meleeValue = initialValue + bonuses->totalValue();
-		meleeCachedLast = treeVersion;
+		boost::lock_guard<boost::mutex> lock(cacheGuard);
+
+		if(treeVersion == meleeCachedLast)
+			return meleeValue;
 	}
 
-	return meleeValue;
+	auto bonuses = target->getBonuses(selector, limit);
+	const int newValue = initialValue + bonuses->totalValue();
+
+	boost::lock_guard<boost::mutex> lock(cacheGuard);
+
+	meleeValue = newValue;
+	meleeCachedLast = treeVersion;
+	return newValue;
 }
 
 int CTotalsProxy::getRangedValue() const
@@ -172,38 +221,58 @@ int CTotalsProxy::getRangedValue() const
 
 	const auto treeVersion = target->getTreeVersion();
 
-	if(treeVersion != rangedCachedLast)
 	{
-		auto bonuses = target->getBonuses(selector, limit);
-		rangedValue = initialValue + bonuses->totalValue();
-		rangedCachedLast = treeVersion;
+		boost::lock_guard<boost::mutex> lock(cacheGuard);
+
+		if(treeVersion == rangedCachedLast)
+			return rangedValue;
 	}
 
-	return rangedValue;
+	auto bonuses = target->getBonuses(selector, limit);
+	const int newValue = initialValue + bonuses->totalValue();
+
+	boost::lock_guard<boost::mutex> lock(cacheGuard);
+
+	rangedValue = newValue;
+	rangedCachedLast = treeVersion;
+	return newValue;
 }
 
 ///CCheckProxy
 CCheckProxy::CCheckProxy(const IBonusBearer * Target, CSelector Selector):
 	target(Target),
 	selector(std::move(Selector)),
-	cachedLast(0),
-	hasBonus(false)
+	cachedState(0)
 {
 }
 
 //This constructor should be placed here to avoid side effects
-CCheckProxy::CCheckProxy(const CCheckProxy & other) = default;
+CCheckProxy::CCheckProxy(const CCheckProxy & other):
+	target(other.target),
+	selector(other.selector),
+	cachedState(other.cachedState.load())
+{
+}
+
+CCheckProxy & CCheckProxy::operator=(const CCheckProxy & other)
+{
+	target = other.target;
+	selector = other.selector;
+	cachedState = other.cachedState.load();
+
+	return *this;
+}
 
 bool CCheckProxy::getHasBonus() const
 {
 	const auto treeVersion = target->getTreeVersion();
+	const auto state = cachedState.load();
 
-	if(treeVersion != cachedLast)
-	{
-		hasBonus = target->hasBonus(selector);
-		cachedLast = treeVersion;
-	}
+	if(state >> 1 == treeVersion)
+		return state & 1;
 
+	const bool hasBonus = target->hasBonus(selector);
+	cachedState = treeVersion << 1 | static_cast<int64_t>(hasBonus);
 	return hasBonus;
 }
 
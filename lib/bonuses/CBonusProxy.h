@@ -44,7 +44,7 @@ public:
 	CTotalsProxy(const CTotalsProxy & other);
 	CTotalsProxy(CTotalsProxy && other) = delete;
 
-	CTotalsProxy & operator=(const CTotalsProxy & other) = default;
+	CTotalsProxy & operator=(const CTotalsProxy & other);
 	CTotalsProxy & operator=(CTotalsProxy && other) = delete;
 
 	int getMeleeValue() const;
@@ -60,6 +60,9 @@ public:
 private:
 	int initialValue;
 
+	/// guards cached values, so concurrent readers never see value of one tree version paired with another
+	mutable boost::mutex cacheGuard;
+
 	mutable int64_t valueCachedLast = 0;
 	mutable int value = 0;
 
@@ -75,7 +78,7 @@ class DLL_LINKAGE CCheckProxy
 public:
 	CCheckProxy(const IBonusBearer * Target, CSelector Selector);
 	CCheckProxy(const CCheckProxy & other);
-	CCheckProxy& operator= (const CCheckProxy & other) = default;
+	CCheckProxy& operator= (const CCheckProxy & other);
 
 	bool getHasBonus() const;
 
@@ -83,8 +86,9 @@ private:
 	const IBonusBearer * target;
 	CSelector selector;
 
-	mutable int64_t cachedLast;
-	mutable bool hasBonus;
+	/// tree version of last check shifted left by one with check result in lowest bit
+	/// kept in single atomic so concurrent readers never see result of one version paired with another
+	mutable std::atomic<int64_t> cachedState;
 };
 
 VCMI_LIB_NAMESPACE_END
\ No newline at end of file
@@ -17,7 +17,10 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+std::atomic<int64_t> CBonusSystemNode::versionCounter(1);
 std::atomic<int64_t> CBonusSystemNode::treeChanged(1);
+std::atomic<int64_t> CBonusSystemNode::cacheHits(0);
+std::atomic<int64_t> CBonusSystemNode::cacheRebuilds(0);
 constexpr bool CBonusSystemNode::cachingEnabled = true;
 
 std::shared_ptr<Bonus> CBonusSystemNode::getLocalBonus(const CSelector & selector)
@@ -107,49 +110,100 @@ void CBonusSystemNode::getAllBonusesRec(BonusList &out, const CSelector & select
 	}
 }
 
+TConstBonusListPtr CBonusSystemNode::getCachedBonuses(const CSelector &selector, bool cacheByKey, const std::string &cachingStr) const
+{
+	if(cacheByKey)
+	{
+		auto it = cachedKeyRequests.find(*selector.getKey());
+		if(it != cachedKeyRequests.end())
+			return it->second;
+	}
+	else if(!cachingStr.empty())
+	{
+		auto it = cachedRequests.find(cachingStr);
+		if(it != cachedRequests.end())
+			return it->second;
+	}
+	return nullptr;
+}
+
 TConstBonusListPtr CBonusSystemNode::getAllBonuses(const CSelector &selector, const CSelector &limit, const std::string &cachingStr) const
 {
 	if (CBonusSystemNode::cachingEnabled)
 	{
+		// Selectors that only compare bonus fields against fixed values are cached using their structural key
+		// Otherwise, request can only be cached if caller have provided caching string
+		const bool cacheByKey = selector.getKey() && (!limit || limit.selectsAll());
+		const bool cacheable = cacheByKey || !cachingStr.empty();
+
+		// Shared access - multiple threads can read cache simultaneously, as long as it is up to date
+		{
+			boost::shared_lock<boost::shared_mutex> lock(sync);
+
+			if (cachedLast == getTreeVersion())
+			{
+				auto cached = getCachedBonuses(selector, cacheByKey, cachingStr);
+
+				if(cached)
+				{
+					cacheHits.fetch_add(1, std::memory_order_relaxed);
+					return cached;
+				}
+
+				if(!cacheable)
+				{
+					// Result of this request won't be stored, so there is no need for exclusive access
+					auto ret = std::make_shared<BonusList>();
+					cachedBonuses.getBonuses(*ret, selector, limit);
+					return ret;
+				}
+			}
+		}
+
 		// Exclusive access for one thread
-		boost::lock_guard<boost::mutex> lock(sync);
+		boost::unique_lock<boost::shared_mutex> lock(sync);
 
-		// If the bonus system tree changes(state of a single node or the relations to each other) then
-		// cache all bonus objects. Selector objects doesn't matter.
-		if (cachedLast != treeChanged)
+		// If the bonus system tree changes(state of this node, any of its ancestors or the relations to each other)
+		// then cache all bonus objects. Selector objects doesn't matter.
+		const int64_t treeVersion = getTreeVersion();
+		if (cachedLast != treeVersion)
 		{
+			cacheRebuilds.fetch_add(1, std::memory_order_relaxed);
+
 			BonusList allBonuses;
 			allBonuses.reserve(cachedBonuses.capacity()); //we assume we'll get about the same number of bonuses
 
 			cachedBonuses.clear();
 			cachedRequests.clear();
+			cachedKeyRequests.clear();
 
 			getAllBonusesRec(allBonuses, Selector::all);
 			limitBonuses(allBonuses, cachedBonuses);
 			cachedBonuses.stackBonuses();
+			cachedBonuses.buildTypeIndex();
 
-			cachedLast = treeChanged;
+			cachedLast = treeVersion;
 		}
-
-		// If a bonus system request comes with a caching string then look up in the map if there are any
-		// pre-calculated bonus results. Limiters can't be cached so they have to be calculated.
-		if(!cachingStr.empty())
+		else
 		{
-			auto it = cachedRequests.find(cachingStr);
-			if(it != cachedRequests.end())
+			// Another thread might have already performed same request while we were waiting for the lock
+			auto cached = getCachedBonuses(selector, cacheByKey, cachingStr);
+			if(cached)
 			{
-				//Cached list contains bonuses for our query with applied limiters
-				return it->second;
+				cacheHits.fetch_add(1, std::memory_order_relaxed);
+				return cached;
 			}
 		}
 
 		//We still don't have the bonuses (didn't returned them from cache)
-		//Perform bonus selection
+		//Perform bonus selection. Limiters can't be cached so they have to be calculated.
 		auto ret = std::make_shared<BonusList>();
 		cachedBonuses.getBonuses(*ret, selector, limit);
 
 		// Save the results in the cache
-		if(!cachingStr.empty())
+		if(cacheByKey)
+			cachedKeyRequests[*selector.getKey()] = ret;
+		else if(!cachingStr.empty())
 			cachedRequests[cachingStr] = ret;
 
 		return ret;
@@ -181,19 +235,21 @@ std::shared_ptr<Bonus> CBonusSystemNode::getUpdatedBonus(const std::shared_ptr<B
 }
 
 CBonusSystemNode::CBonusSystemNode(bool isHypotetic):
-	bonuses(true),
-	exportedBonuses(true),
+	bonuses(this),
+	exportedBonuses(this),
 	nodeType(UNKNOWN),
 	cachedLast(0),
+	nodeChanged(0),
 	isHypotheticNode(isHypotetic)
 {
 }
 
 CBonusSystemNode::CBonusSystemNode(ENodeTypes NodeType):
-	bonuses(true),
-	exportedBonuses(true),
+	bonuses(this),
+	exportedBonuses(this),
 	nodeType(NodeType),
 	cachedLast(0),
+	nodeChanged(0),
 	isHypotheticNode(false)
 {
 }
@@ -224,7 +280,7 @@ void CBonusSystemNode::attachTo(CBonusSystemNode & parent)
 		parent.newChildAttached(*this);
 	}
 
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::attachToSource(const CBonusSystemNode & parent)
@@ -238,7 +294,7 @@ void CBonusSystemNode::attachToSource(const CBonusSystemNode & parent)
 			parent.newRedDescendant(*this);
 	}
 
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::detachFrom(CBonusSystemNode & parent)
@@ -267,7 +323,7 @@ void CBonusSystemNode::detachFrom(CBonusSystemNode & parent)
 	{
 		parent.childDetached(*this);
 	}
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 
@@ -291,7 +347,7 @@ void CBonusSystemNode::detachFromSource(const CBonusSystemNode & parent)
 			, nodeShortInfo(), nodeType, parent.nodeShortInfo(), parent.nodeType);
 	}
 
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::removeBonusesRecursive(const CSelector & s)
@@ -327,7 +383,7 @@ void CBonusSystemNode::addNewBonus(const std::shared_ptr<Bonus>& b)
 	assert(!vstd::contains(exportedBonuses, b));
 	exportedBonuses.push_back(b);
 	exportBonus(b);
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::accumulateBonus(const std::shared_ptr<Bonus>& b)
@@ -346,7 +402,7 @@ void CBonusSystemNode::removeBonus(const std::shared_ptr<Bonus>& b)
 		unpropagateBonus(b);
 	else
 		bonuses -= b;
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::removeBonuses(const CSelector & selector)
@@ -396,11 +452,11 @@ void CBonusSystemNode::unpropagateBonus(const std::shared_ptr<Bonus> & b)
 		else
 			logBonus->warn("Attempt to remove #$# %s, which is not propagated to %s", b->Description(), nodeName());
 
-		bonuses.remove_if([b](const auto & bonus)
+		bonuses.remove_if([this, b](const auto & bonus)
 		{
 			if (bonus->propagationUpdater && bonus->propagationUpdater == b->propagationUpdater)
 			{
-				treeHasChanged();
+				nodeHasChanged();
 				return true;
 			}
 			return false;
@@ -556,7 +612,7 @@ void CBonusSystemNode::exportBonus(const std::shared_ptr<Bonus> & b)
 	else
 		bonuses.push_back(b);
 
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::exportBonuses()
@@ -627,12 +683,51 @@ void CBonusSystemNode::limitBonuses(const BonusList &allBonuses, BonusList &out)
 
 void CBonusSystemNode::treeHasChanged()
 {
-	treeChanged++;
+	treeChanged = ++versionCounter;
+}
+
+void CBonusSystemNode::nodeHasChanged() const
+{
+	// Creature and artifact types are inherited via attachToSource that does not registers inheriting node as a child
+	// Such nodes are only modified during loading, so simply invalidate all caches
+	if(nodeType == CREATURE || nodeType == ARTIFACT)
+	{
+		treeHasChanged();
+		return;
+	}
+
+	invalidateSubtree(++versionCounter);
+}
+
+void CBonusSystemNode::invalidateSubtree(int64_t version) const
+{
+	// node may be reachable via multiple paths, visit it only once
+	if(nodeChanged == version)
+		return;
+
+	nodeChanged = version;
+
+	for(const auto * child : children)
+		child->invalidateSubtree(version);
 }
 
 int64_t CBonusSystemNode::getTreeVersion() const
 {
-	return treeChanged;
+	int64_t result = std::max(treeChanged.load(), nodeChanged.load());
+
+	// hypothetic nodes are not registered as children of their parents, and won't receive invalidation from them
+	if(isHypothetic())
+	{
+		for(const auto * parent : parentsToInherit)
+			vstd::amax(result, parent->getTreeVersion());
+	}
+
+	return result;
+}
+
+std::pair<int64_t, int64_t> CBonusSystemNode::getCacheStatistics()
+{
+	return { cacheHits.load(), cacheRebuilds.load() };
 }
 
 VCMI_LIB_NAMESPACE_END
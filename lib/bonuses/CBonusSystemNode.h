@@ -44,16 +44,27 @@ private:
 	static const bool cachingEnabled;
 	mutable BonusList cachedBonuses;
 	mutable int64_t cachedLast;
+
+	// All versions are taken from single monotonic counter, so node version is simply maximum of
+	// last global change (treeChanged) and last change of this node or any of its ancestors (nodeChanged)
+	static std::atomic<int64_t> versionCounter;
 	static std::atomic<int64_t> treeChanged;
+	mutable std::atomic<int64_t> nodeChanged;
+
+	static std::atomic<int64_t> cacheHits;
+	static std::atomic<int64_t> cacheRebuilds;
 
 	// Setting a value to cachingStr before getting any bonuses caches the result for later requests.
 	// This string needs to be unique, that's why it has to be set in the following manner:
 	// [property key]_[value] => only for selector
 	mutable std::map<std::string, TBonusListPtr > cachedRequests;
-	mutable boost::mutex sync;
+	// Results of requests with selectors that have structural key, cached automatically
+	mutable std::unordered_map<BonusSelectorKey, TBonusListPtr, BonusSelectorKey::Hash> cachedKeyRequests;
+	mutable boost::shared_mutex sync;
 
 	void getAllBonusesRec(BonusList &out, const CSelector & selector) const;
 	TConstBonusListPtr getAllBonusesWithoutCaching(const CSelector &selector, const CSelector &limit) const;
+	TConstBonusListPtr getCachedBonuses(const CSelector &selector, bool cacheByKey, const std::string &cachingStr) const;
 	std::shared_ptr<Bonus> getUpdatedBonus(const std::shared_ptr<Bonus> & b, const TUpdaterPtr & updater) const;
 	void limitBonuses(const BonusList &allBonuses, BonusList &out) const; //out will bo populed with bonuses that are not limited here
 
@@ -75,6 +86,7 @@ private:
 	std::string nodeShortInfo() const;
 
 	void exportBonus(const std::shared_ptr<Bonus> & b);
+	void invalidateSubtree(int64_t version) const;
 
 protected:
 	bool isIndependentNode() const; //node is independent when it has no parents nor children
@@ -120,10 +132,17 @@ public:
 	void setNodeType(CBonusSystemNode::ENodeTypes type);
 	const TCNodesVector & getParentNodes() const;
 
+	/// Invalidates bonus caches of all nodes. Use only if affected node is not known
 	static void treeHasChanged();
 
+	/// Invalidates bonus caches of this node and of all nodes that inherit bonuses from it
+	void nodeHasChanged() const;
+
 	int64_t getTreeVersion() const override;
 
+	/// Returns total number of bonus cache hits and rebuilds, for profiling
+	static std::pair<int64_t, int64_t> getCacheStatistics();
+
 	virtual PlayerColor getOwner() const
 	{
 		return PlayerColor::NEUTRAL;
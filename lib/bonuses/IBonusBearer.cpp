@@ -45,41 +45,34 @@ TConstBonusListPtr IBonusBearer::getBonuses(const CSelector &selector, const CSe
 int IBonusBearer::valOfBonuses(BonusType type) const
 {
 	//This part is performance-critical
-	std::string cachingStr = "type_" + std::to_string(static_cast<int>(type));
-
+	//Selector has structural key, so result will be cached by bonus bearer automatically
 	CSelector s = Selector::type()(type);
 
-	return valOfBonuses(s, cachingStr);
+	return valOfBonuses(s);
 }
 
 bool IBonusBearer::hasBonusOfType(BonusType type) const
 {
 	//This part is performance-critical
-	std::string cachingStr = "type_" + std::to_string(static_cast<int>(type));
-
 	CSelector s = Selector::type()(type);
 
-	return hasBonus(s, cachingStr);
+	return hasBonus(s);
 }
 
 int IBonusBearer::valOfBonuses(BonusType type, BonusSubtypeID subtype) const
 {
 	//This part is performance-critical
-	std::string cachingStr = "type_" + std::to_string(static_cast<int>(type)) + "_" + subtype.toString();
-
 	CSelector s = Selector::typeSubtype(type, subtype);
 
-	return valOfBonuses(s, cachingStr);
+	return valOfBonuses(s);
 }
 
 bool IBonusBearer::hasBonusOfType(BonusType type, BonusSubtypeID subtype) const
 {
 	//This part is performance-critical
-	std::string cachingStr = "type_" + std::to_string(static_cast<int>(type)) + "_" + subtype.toString();
-
 	CSelector s = Selector::typeSubtype(type, subtype);
 
-	return hasBonus(s, cachingStr);
+	return hasBonus(s);
 }
 
 bool IBonusBearer::hasBonusFrom(BonusSource source, BonusSourceID sourceID) const
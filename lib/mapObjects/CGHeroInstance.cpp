@@ -266,11 +266,11 @@ int CGHeroInstance::getLowestCreatureSpeed() const
 void CGHeroInstance::updateArmyMovementBonus(bool onLand, const TurnInfo * ti) const
 {
 	auto realLowestSpeed = lowestSpeed(this);
-	if(lowestCreatureSpeed != realLowestSpeed)
+	// may be called concurrently from movement queries of several AI players, only one of them invalidates the node
+	if(lowestCreatureSpeed.exchange(realLowestSpeed) != realLowestSpeed)
 	{
-		lowestCreatureSpeed = realLowestSpeed;
 		//Let updaters run again
-		treeHasChanged();
+		nodeHasChanged();
 		ti->updateHeroBonuses(BonusType::MOVEMENT, Selector::subtype()(onLand ? BonusCustomSubtype::heroMovementLand : BonusCustomSubtype::heroMovementSea));
 	}
 }
@@ -1490,7 +1490,7 @@ void CGHeroInstance::setPrimarySkill(PrimarySkill primarySkill, si64 value, ui8
 		{
 			skill->val += static_cast<si32>(value);
 		}
-		CBonusSystemNode::treeHasChanged();
+		nodeHasChanged();
 	}
 	else if(primarySkill == PrimarySkill::EXPERIENCE)
 	{
@@ -1527,7 +1527,7 @@ void CGHeroInstance::levelUp(const std::vector<SecondarySkill> & skills)
 	}
 
 	//update specialty and other bonuses that scale with level
-	treeHasChanged();
+	nodeHasChanged();
 }
 
 void CGHeroInstance::levelUpAutomatically(vstd::RNG & rand)
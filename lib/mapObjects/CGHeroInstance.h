@@ -58,7 +58,7 @@ class DLL_LINKAGE CGHeroInstance : public CArmedInstance, public IBoatGenerator,
 
 private:
 	std::set<SpellID> spells; //known spells (spell IDs)
-	mutable int lowestCreatureSpeed;
+	mutable std::atomic<int> lowestCreatureSpeed;
 	ui32 movement; //remaining movement points
 
 public:
@@ -134,42 +134,100 @@ void NetworkConnection::setAsyncWritesEnabled(bool on)
 	asyncWritesEnabled = on;
 }
 
+std::vector<std::byte> NetworkConnection::acquireBuffer()
+{
+	std::lock_guard lock(writeMutex);
+	return takeSpareBuffer();
+}
+
+std::vector<std::byte> NetworkConnection::takeSpareBuffer()
+{
+	if (spareBuffers.empty())
+		return {};
+
+	std::vector<std::byte> buffer = std::move(spareBuffers.back());
+	spareBuffers.pop_back();
+	return buffer;
+}
+
+void NetworkConnection::recycleBuffer(std::vector<std::byte> && buffer)
+{
+	if (spareBuffers.size() >= spareBuffersLimit || buffer.capacity() == 0 || buffer.capacity() > spareBufferMaxCapacity)
+		return;
+
+	buffer.clear();
+	spareBuffers.push_back(std::move(buffer));
+}
+
 void NetworkConnection::sendPacket(const std::vector<std::byte> & message)
 {
 	std::lock_guard lock(writeMutex);
-	std::vector<std::byte> headerVector(sizeof(uint32_t));
-	uint32_t messageSize = message.size();
-	std::memcpy(headerVector.data(), &messageSize, sizeof(uint32_t));
 
 	// At the moment, vcmilobby *requires* async writes in order to handle multiple connections with different speeds and at optimal performance
 	// However server (and potentially - client) can not handle this mode and may shutdown either socket or entire asio service too early, before all writes are performed
 	if (asyncWritesEnabled)
 	{
+		std::vector<std::byte> buffer = takeSpareBuffer();
+		buffer.assign(message.begin(), message.end());
+		queueMessage(std::move(buffer));
+	}
+	else
+		writeMessage(message);
+}
 
-		bool messageQueueEmpty = dataToSend.empty();
-		dataToSend.push_back(headerVector);
-		if (!message.empty())
-			dataToSend.push_back(message);
+void NetworkConnection::sendPacket(std::vector<std::byte> && message)
+{
+	std::lock_guard lock(writeMutex);
 
-		if (messageQueueEmpty)
-			doSendData();
-		//else - data sending loop is still active and still sending previous messages
-	}
+	if (asyncWritesEnabled)
+		queueMessage(std::move(message));
 	else
 	{
-		boost::system::error_code ec;
-		boost::asio::write(*socket, boost::asio::buffer(headerVector), ec );
-		if (!message.empty())
-			boost::asio::write(*socket, boost::asio::buffer(message), ec );
+		writeMessage(message);
+		recycleBuffer(std::move(message));
 	}
 }
 
+void NetworkConnection::writeMessage(const std::vector<std::byte> & message)
+{
+	uint32_t messageSize = message.size();
+	std::array<boost::asio::const_buffer, 2> buffers = {
+		boost::asio::buffer(&messageSize, sizeof(messageSize)),
+		boost::asio::buffer(message)
+	};
+
+	boost::system::error_code ec;
+	boost::asio::write(*socket, buffers, ec);
+}
+
+void NetworkConnection::queueMessage(std::vector<std::byte> && message)
+{
+	uint32_t messageSize = message.size();
+	dataToSend.push_back({messageSize, std::move(message)});
+
+	if (dataSending.empty())
+		doSendData();
+	//else - data sending loop is still active and still sending previous messages
+}
+
 void NetworkConnection::doSendData()
 {
 	if (dataToSend.empty())
 		throw std::runtime_error("Attempting to sent data but there is no data to send!");
 
-	boost::asio::async_write(*socket, boost::asio::buffer(dataToSend.front()), [self = shared_from_this()](const auto & error, const auto & )
+	// Everything queued so far is sent by single write, new messages are queued until it completes
+	std::swap(dataSending, dataToSend);
+
+	std::vector<boost::asio::const_buffer> buffers;
+	buffers.reserve(dataSending.size() * 2);
+	for (const auto & message : dataSending)
+	{
+		buffers.push_back(boost::asio::buffer(&message.size, sizeof(message.size)));
+		if (!message.payload.empty())
+			buffers.push_back(boost::asio::buffer(message.payload));
+	}
+
+	boost::asio::async_write(*socket, buffers, [self = shared_from_this()](const auto & error, const auto & )
 	{
 		self->onDataSent(error);
 	});
@@ -178,7 +236,10 @@ void NetworkConnection::doSendData()
 void NetworkConnection::onDataSent(const boost::system::error_code & ec)
 {
 	std::lock_guard lock(writeMutex);
-	dataToSend.pop_front();
+	for (auto & message : dataSending)
+		recycleBuffer(std::move(message.payload));
+	dataSending.clear();
+
 	if (ec)
 	{
 		onError(ec.message());
@@ -189,6 +250,13 @@ void NetworkConnection::onDataSent(const boost::system::error_code & ec)
 		doSendData();
 }
 
+bool NetworkConnection::isLoopback() const
+{
+	boost::system::error_code ec;
+	auto endpoint = socket->remote_endpoint(ec);
+	return !ec && endpoint.address().is_loopback();
+}
+
 void NetworkConnection::onError(const std::string & message)
 {
 	listener.onDisconnected(shared_from_this(), message);
@@ -16,9 +16,20 @@ VCMI_LIB_NAMESPACE_BEGIN
 class NetworkConnection final : public INetworkConnection, public std::enable_shared_from_this<NetworkConnection>
 {
 	static const int messageHeaderSize = sizeof(uint32_t);
-	static const int messageMaxSize = 64 * 1024 * 1024; // arbitrary size to prevent potential massive allocation if we receive garbage input
+	static const size_t spareBuffersLimit = 16;
+	static const size_t spareBufferMaxCapacity = 1024 * 1024; // don't keep memory of rare huge packets around
+
+	struct OutgoingMessage
+	{
+		uint32_t size;
+		std::vector<std::byte> payload;
+	};
 
-	std::list<std::vector<std::byte>> dataToSend;
+	/// Messages queued while previous write is in progress
+	std::vector<OutgoingMessage> dataToSend;
+	/// Messages that are being written to socket by single gather write
+	std::vector<OutgoingMessage> dataSending;
+	std::vector<std::vector<std::byte>> spareBuffers;
 	std::shared_ptr<NetworkSocket> socket;
 	std::shared_ptr<NetworkTimer> timer;
 	std::mutex writeMutex;
@@ -34,15 +45,24 @@ class NetworkConnection final : public INetworkConnection, public std::enable_sh
 	void onHeaderReceived(const boost::system::error_code & ec);
 	void onPacketReceived(const boost::system::error_code & ec, uint32_t expectedPacketSize);
 
+	void writeMessage(const std::vector<std::byte> & message);
+	void queueMessage(std::vector<std::byte> && message);
+	std::vector<std::byte> takeSpareBuffer();
+	void recycleBuffer(std::vector<std::byte> && buffer);
 	void doSendData();
 	void onDataSent(const boost::system::error_code & ec);
 
 public:
+	static const int messageMaxSize = 64 * 1024 * 1024; // arbitrary size to prevent potential massive allocation if we receive garbage input
+
 	NetworkConnection(INetworkConnectionListener & listener, const std::shared_ptr<NetworkSocket> & socket, const std::shared_ptr<NetworkContext> & context);
 
 	void start();
 	void close() override;
 	void sendPacket(const std::vector<std::byte> & message) override;
+	void sendPacket(std::vector<std::byte> && message) override;
+	std::vector<std::byte> acquireBuffer() override;
+	bool isLoopback() const override;
 	void setAsyncWritesEnabled(bool on) override;
 };
 
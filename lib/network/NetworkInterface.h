@@ -17,6 +17,12 @@ class DLL_LINKAGE INetworkConnection : boost::noncopyable
 public:
 	virtual ~INetworkConnection() = default;
 	virtual void sendPacket(const std::vector<std::byte> & message) = 0;
+	/// Sends message without copying it, buffer may be reused by connection once it has been sent
+	virtual void sendPacket(std::vector<std::byte> && message) = 0;
+	/// Returns empty buffer for next message, reusing memory of already sent messages if possible
+	virtual std::vector<std::byte> acquireBuffer() = 0;
+	/// Returns true if remote side is on the same machine
+	virtual bool isLoopback() const = 0;
 	virtual void setAsyncWritesEnabled(bool on) = 0;
 	virtual void close() = 0;
 };
@@ -11,6 +11,7 @@
 
 #include "StartInfo.h"
 #include "NetPacksBase.h"
+#include "../serializer/ENetworkCompression.h"
 #include "../serializer/ESerializationVersion.h"
 #include "../texts/MetaString.h"
 
@@ -44,6 +45,8 @@ struct DLL_LINKAGE LobbyClientConnected : public CLobbyPackToPropagate
 	int clientId = -1;
 	int hostClientId = -1;
 	ESerializationVersion version = ESerializationVersion::CURRENT;
+	// Set by client to preferred mode, replaced by server with mode that will be used
+	ENetworkCompression compression = ENetworkCompression::NONE;
 
 	void visitTyped(ICPackVisitor & visitor) override;
 
@@ -56,6 +59,9 @@ struct DLL_LINKAGE LobbyClientConnected : public CLobbyPackToPropagate
 		h & clientId;
 		h & hostClientId;
 		h & version;
+		// connection version is not negotiated yet, so presence of field depends on version of the pack itself
+		if (version >= ESerializationVersion::NETWORK_COMPRESSION)
+			h & compression;
 	}
 };
 
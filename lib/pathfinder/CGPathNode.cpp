@@ -53,13 +53,35 @@ int3 CGPath::endPos() const
 }
 
 CPathsInfo::CPathsInfo(const int3 & Sizes, const CGHeroInstance * hero_)
-	: sizes(Sizes), hero(hero_)
+	: sizes(Sizes), hero(hero_), accessibilityInitialized(false), accessibilityUseFlying(false), accessibilityUseWaterWalking(false)
 {
-	nodes.resize(boost::extents[ELayer::NUM_LAYERS][sizes.z][sizes.x][sizes.y]);
+	allocateLayer(ELayer::LAND);
+	allocateLayer(ELayer::SAIL);
 }
 
 CPathsInfo::~CPathsInfo() = default;
 
+void CPathsInfo::allocateLayer(const ELayer layer)
+{
+	nodes[layer.getNum()].resize(boost::extents[sizes.z][sizes.x][sizes.y]);
+}
+
+size_t CPathsInfo::getMemoryUsage() const
+{
+	size_t result = sizeof(CPathsInfo);
+
+	for(const auto & layerNodes : nodes)
+		result += layerNodes.num_elements() * sizeof(CGPathNode);
+
+	return result;
+}
+
+void CPathsInfo::invalidateTiles(const std::unordered_set<int3> & tiles)
+{
+	if(accessibilityInitialized)
+		changedTiles.insert(tiles.begin(), tiles.end());
+}
+
 const CGPathNode * CPathsInfo::getPathInfo(const int3 & tile) const
 {
 	assert(vstd::iswithin(tile.x, 0, sizes.x));
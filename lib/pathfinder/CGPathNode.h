@@ -12,8 +12,6 @@
 #include "../GameConstants.h"
 #include "../int3.h"
 
-#include <boost/heap/fibonacci_heap.hpp>
-
 VCMI_LIB_NAMESPACE_BEGIN
 
 class CGHeroInstance;
@@ -59,11 +57,8 @@ enum class EPathNodeAction : ui8
 
 struct DLL_LINKAGE CGPathNode
 {
-	using TFibHeap = boost::heap::fibonacci_heap<CGPathNode *, boost::heap::compare<NodeComparer<CGPathNode>>>;
 	using ELayer = EPathfindingLayer;
 
-	TFibHeap::handle_type pqHandle;
-	TFibHeap * pq;
 	CGPathNode * theNodeBefore;
 
 	int3 coord; //coordinates
@@ -75,11 +70,11 @@ struct DLL_LINKAGE CGPathNode
 	EPathAccessibility accessible;
 	EPathNodeAction action;
 	bool locked;
+	bool queued; //node has entry in pathfinder queue, see PathfinderQueue
 
 	CGPathNode()
 		: coord(-1),
-		layer(ELayer::WRONG),
-		pqHandle(nullptr)
+		layer(ELayer::WRONG)
 	{
 		reset();
 	}
@@ -93,14 +88,14 @@ struct DLL_LINKAGE CGPathNode
 		cost = std::numeric_limits<float>::max();
 		turns = 255;
 		theNodeBefore = nullptr;
-		pq = nullptr;
+		queued = false;
 		action = EPathNodeAction::UNKNOWN;
 	}
 
 	STRONG_INLINE
 	bool inPQ() const
 	{
-		return pq != nullptr;
+		return queued;
 	}
 
 	STRONG_INLINE
@@ -109,26 +104,11 @@ struct DLL_LINKAGE CGPathNode
 		return cost;
 	}
 
+	/// Queued node has to be pushed again to pathfinder queue after its cost decreased
 	STRONG_INLINE
 	void setCost(float value)
 	{
-		if(vstd::isAlmostEqual(value, cost))
-			return;
-
-		bool getUpNode = value < cost;
 		cost = value;
-		// If the node is in the heap, update the heap.
-		if(inPQ())
-		{
-			if(getUpNode)
-			{
-				pq->increase(this->pqHandle);
-			}
-			else
-			{
-				pq->decrease(this->pqHandle);
-			}
-		}
 	}
 
 	STRONG_INLINE
@@ -188,18 +168,51 @@ struct DLL_LINKAGE CPathsInfo
 	const CGHeroInstance * hero;
 	int3 hpos;
 	int3 sizes;
-	boost::multi_array<CGPathNode, 4> nodes; //[layer][level][w][h]
+	/// Nodes of every layer, [level][w][h]. Land and sail layers are always present,
+	/// other layers are allocated on first use since most heroes can neither fly nor walk on water
+	std::array<boost::multi_array<CGPathNode, 3>, ELayer::NUM_LAYERS> nodes; //[layer]
+
+	/// Set once nodes were initialized by NodeStorage. When storage is reused for next search
+	/// only accessibility of changedTiles is evaluated again, remaining nodes keep their accessibility
+	bool accessibilityInitialized;
+	PlayerColor accessibilityPlayer;
+	bool accessibilityUseFlying;
+	bool accessibilityUseWaterWalking;
+	std::unordered_set<int3> changedTiles;
 
 	CPathsInfo(const int3 & Sizes, const CGHeroInstance * hero_);
 	~CPathsInfo();
+	/// Marks tiles which accessibility may have changed since last search
+	void invalidateTiles(const std::unordered_set<int3> & tiles);
 	const CGPathNode * getPathInfo(const int3 & tile) const;
 	bool getPath(CGPath & out, const int3 & dst) const;
 	const CGPathNode * getNode(const int3 & coord) const;
 
+	void allocateLayer(const ELayer layer);
+	size_t getMemoryUsage() const;
+
+	/// Returns nullptr if layer was never allocated, such layer has no accessible nodes
 	STRONG_INLINE
 	CGPathNode * getNode(const int3 & coord, const ELayer layer)
 	{
-		return &nodes[layer.getNum()][coord.z][coord.x][coord.y];
+		auto & layerNodes = nodes[layer.getNum()];
+
+		if(layerNodes.num_elements() == 0)
+			return nullptr;
+
+		return &layerNodes[coord.z][coord.x][coord.y];
+	}
+
+	/// Allocates layer on first use, called when nodes are initialized
+	STRONG_INLINE
+	CGPathNode * getOrCreateNode(const int3 & coord, const ELayer layer)
+	{
+		auto & layerNodes = nodes[layer.getNum()];
+
+		if(layerNodes.num_elements() == 0)
+			allocateLayer(layer);
+
+		return &layerNodes[coord.z][coord.x][coord.y];
 	}
 };
 
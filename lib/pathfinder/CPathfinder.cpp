@@ -17,6 +17,7 @@
 
 #include "../gameState/CGameState.h"
 #include "../CPlayerState.h"
+#include "../PerformanceStatistics.h"
 #include "../TerrainHandler.h"
 #include "../mapObjects/CGHeroInstance.h"
 #include "../mapObjects/CGTownInstance.h"
@@ -82,25 +83,19 @@ CPathfinder::CPathfinder(CGameState * _gs, std::shared_ptr<PathfinderConfig> con
 
 void CPathfinder::push(CGPathNode * node)
 {
-	if(node && !node->inPQ())
-	{
-		node->pq = &this->pq;
-		auto handle = pq.push(node);
-		node->pqHandle = handle;
-	}
+	if(node)
+		pq.push(node);
 }
 
 CGPathNode * CPathfinder::topAndPop()
 {
-	auto * node = pq.top();
-
-	pq.pop();
-	node->pq = nullptr;
-	return node;
+	return pq.pop();
 }
 
 void CPathfinder::calculatePaths()
 {
+	PerformanceTimer timer("CPathfinder::calculatePaths");
+
 	//logGlobal->info("Calculating paths for hero %s (address  %d) of player %d", hero->name, hero , hero->tempOwner);
 
 	//initial tile - set cost on 0 and add to the queue
@@ -121,16 +116,19 @@ void CPathfinder::calculatePaths()
 		if(hlp->isHeroPatrolLocked())
 			continue;
 
-		pq.push(initialNode);
+		push(initialNode);
 	}
 
 	std::vector<CGPathNode *> neighbourNodes;
 
 	while(!pq.empty())
 	{
-		counter++;
 		auto * node = topAndPop();
 
+		if(!node)
+			continue;
+
+		counter++;
 		source.setNode(gamestate, node);
 		source.node->locked = true;
 
@@ -228,7 +226,8 @@ void CPathfinder::calculatePaths()
 				destination.action = getTeleportDestAction();
 				config->nodeStorage->commit(destination, source);
 
-				if(destination.node->action == EPathNodeAction::TELEPORT_NORMAL)
+				// queued node has to be pushed again since it became cheaper
+				if(destination.node->action == EPathNodeAction::TELEPORT_NORMAL || destination.node->inPQ())
 					push(destination.node);
 			}
 		}
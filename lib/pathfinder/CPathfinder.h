@@ -10,6 +10,7 @@
 #pragma once
 
 #include "CGPathNode.h"
+#include "PathfinderQueue.h"
 #include "../IGameCallback.h"
 #include "../bonuses/BonusEnum.h"
 
@@ -48,7 +49,7 @@ private:
 
 	std::shared_ptr<PathfinderConfig> config;
 
-	boost::heap::fibonacci_heap<CGPathNode *, boost::heap::compare<NodeComparer<CGPathNode>> > pq;
+	PathfinderQueue<CGPathNode> pq;
 
 	PathNodeInfo source; //current (source) path node -> we took it from the queue
 	CDestinationNodeInfo destination; //destination node -> it's a neighbour of source that we consider
@@ -30,9 +30,28 @@ void NodeStorage::initialize(const PathfinderOptions & options, const CGameState
 	const int3 sizes = gs->getMapSize();
 	const auto & fow = static_cast<const CGameInfoCallback *>(gs)->getPlayerTeam(player)->fogOfWarMap;
 
-	//make 200% sure that these are loop invariants (also a bit shorter code), let compiler do the rest(loop unswitching)
-	const bool useFlying = options.useFlying;
-	const bool useWaterWalking = options.useWaterWalking;
+	if(out.accessibilityInitialized)
+	{
+		// storage was used by previous search - accessibility of nodes can be reused unless it was evaluated with different settings
+		if(out.accessibilityPlayer == player
+			&& out.accessibilityUseFlying == options.useFlying
+			&& out.accessibilityUseWaterWalking == options.useWaterWalking)
+		{
+			resetSearchState();
+
+			for(const int3 & tile : out.changedTiles)
+			{
+				if(gs->isInTheMap(tile))
+					initializeTile(tile, options, gs, fow, player);
+			}
+
+			out.changedTiles.clear();
+			return;
+		}
+
+		for(auto & layerNodes : out.nodes)
+			std::fill_n(layerNodes.data(), layerNodes.num_elements(), CGPathNode());
+	}
 
 	for(pos.z=0; pos.z < sizes.z; ++pos.z)
 	{
@@ -40,22 +59,56 @@ void NodeStorage::initialize(const PathfinderOptions & options, const CGameState
 		{
 			for(pos.y=0; pos.y < sizes.y; ++pos.y)
 			{
-				const TerrainTile & tile = gs->map->getTile(pos);
-				if(tile.terType->isWater())
-				{
-					resetTile(pos, ELayer::SAIL, PathfinderUtil::evaluateAccessibility<ELayer::SAIL>(pos, tile, fow, player, gs));
-					if(useFlying)
-						resetTile(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs));
-					if(useWaterWalking)
-						resetTile(pos, ELayer::WATER, PathfinderUtil::evaluateAccessibility<ELayer::WATER>(pos, tile, fow, player, gs));
-				}
-				if(tile.terType->isLand())
-				{
-					resetTile(pos, ELayer::LAND, PathfinderUtil::evaluateAccessibility<ELayer::LAND>(pos, tile, fow, player, gs));
-					if(useFlying)
-						resetTile(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs));
-				}
+				initializeTile(pos, options, gs, fow, player);
+			}
+		}
+	}
+
+	out.accessibilityInitialized = true;
+	out.accessibilityPlayer = player;
+	out.accessibilityUseFlying = options.useFlying;
+	out.accessibilityUseWaterWalking = options.useWaterWalking;
+	out.changedTiles.clear();
+}
+
+void NodeStorage::initializeTile(const int3 & pos, const PathfinderOptions & options, const CGameState * gs, const PathfinderUtil::FoW & fow, const PlayerColor player)
+{
+	const TerrainTile & tile = gs->map->getTile(pos);
+	if(tile.terType->isWater())
+	{
+		resetTile(pos, ELayer::SAIL, PathfinderUtil::evaluateAccessibility<ELayer::SAIL>(pos, tile, fow, player, gs));
+		if(options.useFlying)
+			resetTile(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs));
+		if(options.useWaterWalking)
+			resetTile(pos, ELayer::WATER, PathfinderUtil::evaluateAccessibility<ELayer::WATER>(pos, tile, fow, player, gs));
+	}
+	if(tile.terType->isLand())
+	{
+		resetTile(pos, ELayer::LAND, PathfinderUtil::evaluateAccessibility<ELayer::LAND>(pos, tile, fow, player, gs));
+		if(options.useFlying)
+			resetTile(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs));
+	}
+}
+
+void NodeStorage::resetSearchState()
+{
+	for(auto & layerNodes : out.nodes)
+	{
+		CGPathNode * const nodesBegin = layerNodes.data();
+		CGPathNode * const nodesEnd = nodesBegin + layerNodes.num_elements();
+
+		for(CGPathNode * node = nodesBegin; node != nodesEnd; ++node)
+		{
+			if(node->layer == ELayer::WRONG)
+			{
+				// node was never initialized but may still be modified by search, e.g. used as initial node
+				*node = CGPathNode();
+				continue;
 			}
+
+			const EPathAccessibility accessible = node->accessible;
+			node->reset();
+			node->accessible = accessible;
 		}
 	}
 }
@@ -77,7 +130,7 @@ void NodeStorage::calculateNeighbours(
 	{
 		auto * node = getNode(neighbour, layer);
 
-		if(node->accessible == EPathAccessibility::NOT_SET)
+		if(!node || node->accessible == EPathAccessibility::NOT_SET)
 			continue;
 
 		result.push_back(node);
@@ -100,7 +153,7 @@ std::vector<CGPathNode *> NodeStorage::calculateTeleportations(
 	{
 		auto * node = getNode(neighbour, source.node->layer);
 
-		if(!node->coord.valid())
+		if(!node || !node->coord.valid())
 		{
 			logAi->debug("Teleportation exit is blocked " + neighbour.toString());
 			continue;
@@ -121,12 +174,12 @@ NodeStorage::NodeStorage(CPathsInfo & pathsInfo, const CGHeroInstance * hero)
 
 void NodeStorage::resetTile(const int3 & tile, const EPathfindingLayer & layer, EPathAccessibility accessibility)
 {
-	getNode(tile, layer)->update(tile, layer, accessibility);
+	out.getOrCreateNode(tile, layer)->update(tile, layer, accessibility);
 }
 
 std::vector<CGPathNode *> NodeStorage::getInitialNodes()
 {
-	auto * initialNode = getNode(out.hpos, out.hero->boat ? out.hero->boat->layer : EPathfindingLayer::LAND);
+	auto * initialNode = out.getOrCreateNode(out.hpos, out.hero->boat ? out.hero->boat->layer : EPathfindingLayer::LAND);
 
 	initialNode->turns = 0;
 	initialNode->moveRemains = out.hero->movementPointsRemaining();
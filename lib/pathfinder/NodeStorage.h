@@ -22,6 +22,12 @@ private:
 	STRONG_INLINE
 	void resetTile(const int3 & tile, const EPathfindingLayer & layer, EPathAccessibility accessibility);
 
+	STRONG_INLINE
+	void initializeTile(const int3 & pos, const PathfinderOptions & options, const CGameState * gs, const boost::multi_array<ui8, 3> & fow, const PlayerColor player);
+
+	/// Clears results of previous search but keeps accessibility of nodes
+	void resetSearchState();
+
 public:
 	NodeStorage(CPathsInfo & pathsInfo, const CGHeroInstance * hero);
 
@@ -63,6 +63,11 @@ SingleHeroPathfinderConfig::SingleHeroPathfinderConfig(CPathsInfo & out, CGameSt
 	: PathfinderConfig(std::make_shared<NodeStorage>(out, hero), gs, buildRuleSet())
 {
 	pathfinderHelper = std::make_unique<CPathfinderHelper>(gs, hero, options);
+
+	// bonuses of later turns are subset of current ones, so layer that is not available now will never be used
+	// this way nodes of such layers are neither initialized nor allocated
+	options.useFlying = pathfinderHelper->isLayerAvailable(EPathfindingLayer::AIR);
+	options.useWaterWalking = pathfinderHelper->isLayerAvailable(EPathfindingLayer::WATER);
 }
 
 CPathfinderHelper * SingleHeroPathfinderConfig::getOrCreatePathfinderHelper(const PathNodeInfo & source, CGameState * gs)
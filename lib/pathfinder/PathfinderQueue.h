@@ -0,0 +1,143 @@
+/*
+ * PathfinderQueue.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+/// Monotone priority queue of path nodes ordered by node cost (radix heap)
+/// Pathfinder never pushes node that is cheaper than last popped one, so bits of non-negative float costs
+/// can be used as integer keys. Entries are distributed into buckets by highest bit that differs from last
+/// popped key - push does not allocate once buckets have grown and nodes don't need to store heap handles.
+///
+/// Node cost may change while node is queued. Node can be pushed again, outdated entries are skipped on pop.
+/// TNode must provide getCost() and inPQ() and bool field 'queued'.
+template<typename TNode>
+class PathfinderQueue
+{
+	struct Entry
+	{
+		uint32_t key;
+		TNode * node;
+	};
+
+	static constexpr int BUCKETS_COUNT = 33;
+
+	std::array<std::vector<Entry>, BUCKETS_COUNT> buckets;
+	uint32_t lastKey = 0;
+	size_t entriesCount = 0;
+
+	static uint32_t toKey(float cost)
+	{
+		// bits of non-negative floats preserve their ordering
+		if(!(cost > 0))
+			return 0;
+
+		uint32_t result;
+		std::memcpy(&result, &cost, sizeof(result));
+		return result;
+	}
+
+	int bucketIndex(uint32_t key) const
+	{
+		uint32_t difference = key ^ lastKey;
+		int result = 0;
+
+		while(difference)
+		{
+			difference >>= 1;
+			result++;
+		}
+
+		return result;
+	}
+
+	void insert(TNode * node, uint32_t key)
+	{
+		// key can not be lower than last popped one, such node is just processed next
+		vstd::amax(key, lastKey);
+		buckets[bucketIndex(key)].push_back(Entry{key, node});
+		entriesCount++;
+	}
+
+	void refill()
+	{
+		int index = 1;
+
+		while(buckets[index].empty())
+			index++;
+
+		auto & source = buckets[index];
+
+		lastKey = source.front().key;
+		for(const auto & entry : source)
+			vstd::amin(lastKey, entry.key);
+
+		// all entries of bucket share same higher bits with new last key so they always move to lower buckets
+		for(const auto & entry : source)
+			buckets[bucketIndex(entry.key)].push_back(entry);
+
+		source.clear();
+	}
+
+public:
+	bool empty() const
+	{
+		return entriesCount == 0;
+	}
+
+	void clear()
+	{
+		for(auto & bucket : buckets)
+			bucket.clear();
+
+		lastKey = 0;
+		entriesCount = 0;
+	}
+
+	void push(TNode * node)
+	{
+		node->queued = true;
+		insert(node, toKey(node->getCost()));
+	}
+
+	/// Returns node with lowest cost or nullptr if popped entry was outdated
+	TNode * pop()
+	{
+		assert(!empty());
+
+		if(buckets[0].empty())
+			refill();
+
+		Entry entry = buckets[0].back();
+		buckets[0].pop_back();
+		entriesCount--;
+
+		TNode * node = entry.node;
+
+		// node was already popped using another entry
+		if(!node->inPQ())
+			return nullptr;
+
+		uint32_t actualKey = toKey(node->getCost());
+
+		// node became more expensive while queued - move it back
+		// cheaper node either has been popped by its up-to-date entry already or should be processed now
+		if(actualKey > entry.key)
+		{
+			insert(node, actualKey);
+			return nullptr;
+		}
+
+		node->queued = false;
+		return node;
+	}
+};
+
+VCMI_LIB_NAMESPACE_END
@@ -29,7 +29,7 @@
 #include "Zone.h"
 #include "Functions.h"
 #include "RmgMap.h"
-#include "threadpool/ThreadPool.h"
+#include "modificators/Modificator.h"
 #include "modificators/ObjectManager.h"
 #include "modificators/TreasurePlacer.h"
 #include "modificators/RoadPlacer.h"
@@ -37,11 +37,15 @@
 #include <vstd/RNG.h>
 #include <vcmi/HeroTypeService.h>
 
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
 VCMI_LIB_NAMESPACE_BEGIN
 
 CMapGenerator::CMapGenerator(CMapGenOptions& mapGenOptions, IGameCallback * cb, int RandomSeed) :
 	mapGenOptions(mapGenOptions), randomSeed(RandomSeed),
 	monolithIndex(0),
+	threadCount(0),
 	rand(std::make_unique<CRandomGenerator>(RandomSeed))
 {
 	loadConfig();
@@ -87,6 +91,12 @@ void CMapGenerator::loadConfig()
 	config.pandoraSpellSchool = randomMapJson["pandoras"]["valueSpellSchool"].Integer();
 	config.pandoraSpell60 = randomMapJson["pandoras"]["valueSpell60"].Integer();
 	config.singleThread = randomMapJson["singleThread"].Bool();
+	threadCount = config.singleThread ? 1 : 0;
+}
+
+void CMapGenerator::setThreadCount(unsigned int count)
+{
+	threadCount = count;
 }
 
 const CMapGenerator::Config & CMapGenerator::getConfig() const
@@ -329,6 +339,147 @@ void CMapGenerator::addWaterTreasuresInfo()
 	}
 }
 
+void CMapGenerator::logCriticalPath(const std::vector<Modificator *> & finishedJobs) const
+{
+	// finishing order is topological, so longest chain ending in each job can be found in one pass
+	std::map<const Modificator *, int64_t> chainTime;
+	std::map<const Modificator *, const Modificator *> chainPrevious;
+	const Modificator * last = nullptr;
+
+	for (const auto * job : finishedJobs)
+	{
+		logGlobal->debug("Modificator zone %d - %s - took %d ms", job->getZone().getId(), job->getName(), job->getProcessTime());
+
+		chainTime[job] += job->getProcessTime();
+
+		for (const auto * dependent : job->getDependents())
+		{
+			if (chainTime[dependent] < chainTime[job])
+			{
+				chainTime[dependent] = chainTime[job];
+				chainPrevious[dependent] = job;
+			}
+		}
+
+		if (!last || chainTime[job] > chainTime[last])
+			last = job;
+	}
+
+	if (!last)
+		return;
+
+	std::string path;
+
+	for (const auto * job = last; job; job = chainPrevious[job])
+	{
+		auto step = boost::str(boost::format("zone %d %s (%d ms)") % job->getZone().getId() % job->getName() % job->getProcessTime());
+		path = path.empty() ? step : step + " -> " + path;
+	}
+
+	logGlobal->info("Modificators critical path takes %d ms: %s", chainTime[last], path);
+}
+
+std::vector<Modificator *> CMapGenerator::scheduleModificators(const std::list<std::shared_ptr<Modificator>> & jobs) const
+{
+	//Reference order is the one of sequential generation: always run first listed job with all preceeders finished
+	std::vector<Modificator *> listed;
+	std::map<const Modificator *, size_t> listIndex;
+	for (const auto & job : jobs)
+	{
+		listIndex[job.get()] = listed.size();
+		listed.push_back(job.get());
+	}
+
+	std::vector<size_t> unfinishedPreceeders(listed.size(), 0);
+	std::vector<std::vector<size_t>> dependents(listed.size());
+	std::set<size_t> ready;
+	for (size_t i = 0; i < listed.size(); ++i)
+	{
+		for (const auto * preceeder : listed[i]->getPreceeders())
+		{
+			auto it = listIndex.find(preceeder);
+			if (it == listIndex.end())
+				continue;
+
+			dependents[it->second].push_back(i);
+			unfinishedPreceeders[i]++;
+		}
+		if (unfinishedPreceeders[i] == 0)
+			ready.insert(i);
+	}
+
+	std::vector<Modificator *> order;
+	order.reserve(listed.size());
+	while (!ready.empty())
+	{
+		size_t current = *ready.begin();
+		ready.erase(ready.begin());
+		order.push_back(listed[current]);
+
+		for (size_t dependent : dependents[current])
+		{
+			if (--unfinishedPreceeders[dependent] == 0)
+				ready.insert(dependent);
+		}
+	}
+
+	//Neighbourhood of a zone are tiles its modificators may touch: own zone, adjacent zones and connected zones
+	std::map<TRmgTemplateZoneId, std::set<TRmgTemplateZoneId>> neighbourhood;
+	for (const auto & zone : map->getZones())
+	{
+		auto & zones = neighbourhood[zone.first];
+		zones.insert(zone.first);
+		for (const auto & tile : zone.second->area()->getBorderOutside().getTilesVector())
+		{
+			if (map->isOnMap(tile))
+				zones.insert(map->getZoneID(tile));
+		}
+		for (auto connectedZone : zone.second->getConnectedZoneIds())
+			zones.insert(connectedZone);
+	}
+
+	auto overlaps = [&neighbourhood](TRmgTemplateZoneId a, TRmgTemplateZoneId b)
+	{
+		const auto & first = neighbourhood[a];
+		const auto & second = neighbourhood[b];
+		return std::any_of(first.begin(), first.end(), [&second](TRmgTemplateZoneId id)
+		{
+			return vstd::contains(second, id);
+		});
+	};
+
+	//Conflicting jobs are ordered as in reference order. It is enough to wait for the last conflicting job
+	//of every zone and of every shared footprint, since those are ordered among themselves already
+	std::map<TRmgTemplateZoneId, Modificator *> lastInZone;
+	Modificator * lastWholeMap = nullptr;
+	Modificator * lastSharedPools = nullptr;
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		auto * job = order[i];
+		auto footprint = job->getFootprint();
+		auto zoneId = job->getZone().getId();
+
+		job->setCommitOrder(i);
+
+		for (const auto & last : lastInZone)
+		{
+			if (footprint == Modificator::EFootprint::WHOLE_MAP || overlaps(zoneId, last.first))
+				job->dependency(last.second);
+		}
+		job->dependency(lastWholeMap);
+		if (footprint == Modificator::EFootprint::SHARED_POOLS)
+			job->dependency(lastSharedPools);
+
+		lastInZone[zoneId] = job;
+		if (footprint == Modificator::EFootprint::WHOLE_MAP)
+			lastWholeMap = job;
+		if (footprint == Modificator::EFootprint::SHARED_POOLS)
+			lastSharedPools = job;
+	}
+
+	return order;
+}
+
 void CMapGenerator::fillZones()
 {
 	addWaterTreasuresInfo();
@@ -358,68 +509,72 @@ void CMapGenerator::fillZones()
 
 	Load::Progress::setupStepsTill(allJobs.size(), 240);
 
-	if (config.singleThread) //No thread pool, just queue with deterministic order
+	auto referenceOrder = scheduleModificators(allJobs);
+
+	for (auto & job : allJobs)
+		job->prepareScheduling();
+
+	std::vector<Modificator *> finishedJobs;
+	finishedJobs.reserve(allJobs.size());
+
+	unsigned int threads = threadCount ? threadCount : boost::thread::hardware_concurrency();
+
+	if (threads <= 1) //No thread pool, just run jobs in reference order
 	{
-		while (!allJobs.empty())
+		for (auto * job : referenceOrder)
 		{
-			for (auto it = allJobs.begin(); it != allJobs.end();)
-			{
-				if ((*it)->isReady())
-				{
-					auto jobCopy = *it;
-					jobCopy->run();
-					Progress::Progress::step(); //Update progress bar
-					allJobs.erase(it);
-					break; //Restart from the first job
-				}
-				else
-				{
-					++it;
-				}
-			}
+			job->run();
+			finishedJobs.push_back(job);
+			Progress::Progress::step(); //Update progress bar
 		}
 	}
 	else
 	{
-		ThreadPool pool;
-		std::vector<boost::future<void>> futures;
-		//At most one Modificator can run for every zone
-		pool.init(std::min<int>(boost::thread::hardware_concurrency(), numZones));
+		//Every finished job starts its dependents which have no other unfinished preceeders, nothing is polled
+		boost::mutex finishedJobsMutex;
+		tbb::task_arena arena(threads);
+		tbb::task_group tasks;
 
-		while (!allJobs.empty())
+		std::function<void(Modificator *)> runJob = [&](Modificator * job)
 		{
-			for (auto it = allJobs.begin(); it != allJobs.end();)
+			tasks.run([&, job]()
 			{
-				if ((*it)->isFinished())
-				{
-					it = allJobs.erase(it);
-					Progress::Progress::step();
-				}
-				else if ((*it)->isReady())
+				job->run();
+				Progress::Progress::step(); //Update progress bar
+
 				{
-					auto jobCopy = *it;
-					futures.emplace_back(pool.async([this, jobCopy]() -> void
-						{
-							jobCopy->run();
-							Progress::Progress::step(); //Update progress bar
-						}
-					));
-					it = allJobs.erase(it);
+					boost::lock_guard<boost::mutex> lock(finishedJobsMutex);
+					finishedJobs.push_back(job);
 				}
-				else
+
+				for (auto * dependent : job->getDependents())
 				{
-					++it;
+					if (dependent->releasePreceeder())
+						runJob(dependent);
 				}
-			}
-		}
+			});
+		};
 
-		//Wait for all the tasks
-		for (auto& fut : futures)
+		arena.execute([&]()
 		{
-			fut.get();
-		}
+			for (auto * job : referenceOrder)
+			{
+				if (!job->hasUnfinishedPreceeders())
+					runJob(job);
+			}
+
+			tasks.wait();
+		});
 	}
 
+	if (finishedJobs.size() != allJobs.size())
+		logGlobal->error("Only %d of %d modificators were run, dependencies contain a cycle", finishedJobs.size(), allJobs.size());
+
+	//Object ids and names are given in reference order, not in order in which jobs have finished
+	map->getMapProxy()->commitObjects();
+
+	logCriticalPath(finishedJobs);
+
 	for (const auto& it : map->getZones())
 	{
 		if (it.second->getType() == ETemplateZoneType::TREASURE)
@@ -25,6 +25,7 @@ class RmgMap;
 class CMap;
 class Zone;
 class CZonePlacer;
+class Modificator;
 class IGameCallback;
 
 using JsonVector = std::vector<JsonNode>;
@@ -76,6 +77,9 @@ public:
 	void addWaterTreasuresInfo();
 
 	int getRandomSeed() const;
+
+	/// Number of threads used to fill zones, 0 means hardware concurrency. Generated map is the same for any count
+	void setThreadCount(unsigned int count);
 	
 private:
 	std::unique_ptr<vstd::RNG> rand;
@@ -88,6 +92,7 @@ private:
 	std::vector<rmg::ZoneConnection> connectionsLeft;
 	
 	int monolithIndex;
+	unsigned int threadCount;
 	std::vector<ArtifactID> questArtifacts;
 
 	/// Generation methods
@@ -101,6 +106,8 @@ private:
 	void addHeaderInfo();
 	void genZones();
 	void fillZones();
+	std::vector<Modificator *> scheduleModificators(const std::list<std::shared_ptr<Modificator>> & jobs) const;
+	void logCriticalPath(const std::vector<Modificator *> & finishedJobs) const;
 };
 
 VCMI_LIB_NAMESPACE_END
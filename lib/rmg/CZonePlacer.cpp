@@ -349,24 +349,20 @@ void CZonePlacer::placeZones(vstd::RNG * rand)
 	//0. set zone sizes and surface / underground level
 	prepareZones(zones, zonesVector, underground, rand);
 
-	std::map<std::shared_ptr<Zone>, float3> bestSolution;
+	ZoneLayout layout;
+	prepareLayout(zones, layout);
+	std::vector<float3> bestSolution(layout.count());
 
-	TForceVector forces;
-	TForceVector totalForces; //  both attraction and pushback, overcomplicated?
-	TDistanceVector distances;
-	TDistanceVector overlaps;
-
-	auto evaluateSolution = [this, zones, &distances, &overlaps, &bestSolution]() -> bool
+	auto evaluateSolution = [this, &layout, &bestSolution]() -> bool
 	{
 		bool improvement = false;
 
 		float totalDistance = 0;
 		float totalOverlap = 0;
-		for (const auto& zone : distances) //find most misplaced zone
+		for (size_t i = 0; i < layout.count(); i++) //find most misplaced zone
 		{
-			totalDistance += zone.second;
-			float overlap = overlaps[zone.first];
-			totalOverlap += overlap;
+			totalDistance += layout.distances[i];
+			totalOverlap += layout.overlaps[i];
 		}
 
 		//check fitness function
@@ -382,8 +378,8 @@ void CZonePlacer::placeZones(vstd::RNG * rand)
 			bestTotalDistance = totalDistance;
 			bestTotalOverlap = totalOverlap;
 
-			for (const auto& zone : zones)
-				bestSolution[zone.second] = zone.second->getCenter();
+			for (size_t i = 0; i < layout.count(); i++)
+				bestSolution[i] = layout.getCenter(i);
 		}
 
 #ifdef ZONE_PLACEMENT_LOG
@@ -397,19 +393,21 @@ void CZonePlacer::placeZones(vstd::RNG * rand)
 	for (stifness = stiffnessConstant / zones.size(); stifness <= stiffnessConstant;)
 	{
 		//1. attract connected zones
-		attractConnectedZones(zones, forces, distances);
-		for(const auto & zone : forces)
+		attractConnectedZones(layout);
+		for (size_t i = 0; i < layout.count(); i++)
 		{
-			zone.first->setCenter (zone.first->getCenter() + zone.second);
-			totalForces[zone.first] = zone.second; //override
+			layout.setCenter(i, float3(layout.x[i] + layout.forceX[i], layout.y[i] + layout.forceY[i], layout.z[i]));
+			layout.totalForceX[i] = layout.forceX[i]; //override
+			layout.totalForceY[i] = layout.forceY[i];
 		}
 
 		//2. separate overlapping zones
-		separateOverlappingZones(zones, forces, overlaps);
-		for(const auto & zone : forces)
+		separateOverlappingZones(layout);
+		for (size_t i = 0; i < layout.count(); i++)
 		{
-			zone.first->setCenter (zone.first->getCenter() + zone.second);
-			totalForces[zone.first] += zone.second; //accumulate
+			layout.setCenter(i, float3(layout.x[i] + layout.forceX[i], layout.y[i] + layout.forceY[i], layout.z[i]));
+			layout.totalForceX[i] += layout.forceX[i]; //accumulate
+			layout.totalForceY[i] += layout.forceY[i];
 		}
 
 		bool improved = evaluateSolution();
@@ -418,7 +416,7 @@ void CZonePlacer::placeZones(vstd::RNG * rand)
 		{
 			//3. now perform drastic movement of zone that is completely not linked
 			//TODO: Don't do this is fitness was improved
-			moveOneZone(zones, totalForces, distances, overlaps);
+			moveOneZone(layout);
 
 			improved |= evaluateSolution();
 		}
@@ -432,15 +430,94 @@ void CZonePlacer::placeZones(vstd::RNG * rand)
 	}
 
 	logGlobal->trace("Best fitness reached: total distance %2.4f, total overlap %2.4f", bestTotalDistance, bestTotalOverlap);
-	for(const auto & zone : zones) //finalize zone positions
+	for (size_t i = 0; i < layout.count(); i++) //finalize zone positions
 	{
-		zone.second->setPos (cords (bestSolution[zone.second]));
+		const auto & zone = layout.zones[i];
+		zone->setPos (cords (bestSolution[i]));
 #ifdef ZONE_PLACEMENT_LOG
-		logGlobal->trace("Placed zone %d at relative position %s and coordinates %s", zone.first, zone.second->getCenter().toString(), zone.second->getPos().toString());
+		logGlobal->trace("Placed zone %d at relative position %s and coordinates %s", zone->getId(), zone->getCenter().toString(), zone->getPos().toString());
 #endif
 	}
 }
 
+void CZonePlacer::ZoneLayout::setCenter(size_t zone, const float3 & center)
+{
+	//Zone keeps its center wrapped inside (0,1) square, mirror that
+	zones[zone]->setCenter(center);
+	float3 wrapped = zones[zone]->getCenter();
+	x[zone] = wrapped.x;
+	y[zone] = wrapped.y;
+	z[zone] = wrapped.z;
+}
+
+void CZonePlacer::prepareLayout(const TZoneMap & zones, ZoneLayout & layout) const
+{
+	const size_t count = zones.size();
+
+	for(const auto & zone : zones)
+	{
+		layout.indexById[zone.first] = layout.zones.size();
+		layout.zones.push_back(zone.second);
+		float3 center = zone.second->getCenter();
+		layout.x.push_back(center.x);
+		layout.y.push_back(center.y);
+		layout.z.push_back(center.z);
+		layout.size.push_back(zone.second->getSize());
+	}
+
+	layout.forceX.assign(count, 0);
+	layout.forceY.assign(count, 0);
+	layout.totalForceX.assign(count, 0);
+	layout.totalForceY.assign(count, 0);
+	layout.distances.assign(count, 0);
+	layout.overlaps.assign(count, 0);
+	layout.graphDistance.assign(count * count, 0);
+	layout.forceScale.assign(count * count, 0);
+	layout.attracted.resize(count);
+	layout.repulsed.resize(count);
+
+	for(size_t i = 0; i < count; i++)
+	{
+		const auto & zone = layout.zones[i];
+		auto distancesFromZone = distancesBetweenZones.find(zone->getId());
+
+		for(size_t j = 0; j < count; j++)
+		{
+			const auto & otherZone = layout.zones[j];
+			if(distancesFromZone != distancesBetweenZones.end())
+			{
+				auto distance = distancesFromZone->second.find(otherZone->getId());
+				if(distance != distancesFromZone->second.end())
+					layout.graphDistance[i * count + j] = static_cast<float>(distance->second);
+			}
+			layout.forceScale[i * count + j] = scaleForceBetweenZones(zone, otherZone);
+		}
+
+		for (const auto & connection : zone->getConnections())
+		{
+			auto other = layout.indexById.find(connection.getOtherZoneId(zone->getId()));
+			if (other == layout.indexById.end())
+				continue;
+
+			switch (connection.getConnectionType())
+			{
+				case rmg::EConnectionType::REPULSIVE:
+					layout.repulsed[i].push_back(other->second);
+					continue;
+				//Do not consider virtual connections for graph distance
+				case rmg::EConnectionType::FORCE_PORTAL:
+					continue;
+			}
+			if (connection.getZoneA() == connection.getZoneB())
+			{
+				//Do not consider self-connections
+				continue;
+			}
+			layout.attracted[i].push_back(other->second);
+		}
+	}
+}
+
 void CZonePlacer::prepareZones(TZoneMap &zones, TZoneVector &zonesVector, const bool underground, vstd::RNG * rand)
 {
 	std::vector<float> totalSize = { 0, 0 }; //make sure that sum of zone sizes on surface and uderground match size of the map
@@ -551,34 +628,22 @@ void CZonePlacer::prepareZones(TZoneMap &zones, TZoneVector &zonesVector, const
 	}
 }
 
-void CZonePlacer::attractConnectedZones(TZoneMap & zones, TForceVector & forces, TDistanceVector & distances) const
+void CZonePlacer::attractConnectedZones(ZoneLayout & layout) const
 {
-	for(const auto & zone : zones)
+	const size_t count = layout.count();
+
+	for(size_t i = 0; i < count; i++)
 	{
 		float3 forceVector(0, 0, 0);
-		float3 pos = zone.second->getCenter();
+		float3 pos = layout.getCenter(i);
 		float totalDistance = 0;
 
-		for (const auto & connection : zone.second->getConnections())
+		for (size_t other : layout.attracted[i])
 		{
-			switch (connection.getConnectionType())
-			{
-				//Do not consider virtual connections for graph distance
-				case rmg::EConnectionType::REPULSIVE:
-				case rmg::EConnectionType::FORCE_PORTAL:
-					continue;
-			}
-			if (connection.getZoneA() == connection.getZoneB())
-			{
-				//Do not consider self-connections
-				continue;
-			}
-
-			auto otherZone = zones[connection.getOtherZoneId(zone.second->getId())];
-			float3 otherZoneCenter = otherZone->getCenter();
+			float3 otherZoneCenter = layout.getCenter(other);
 			auto distance = static_cast<float>(pos.dist2d(otherZoneCenter));
 			
-			forceVector += (otherZoneCenter - pos) * distance * gravityConstant * scaleForceBetweenZones(zone.second, otherZone); //positive value
+			forceVector += (otherZoneCenter - pos) * distance * gravityConstant * layout.forceScale[i * count + other]; //positive value
 
 			//Attract zone centers always
 
@@ -587,48 +652,64 @@ void CZonePlacer::attractConnectedZones(TZoneMap & zones, TForceVector & forces,
 			if (pos.z != otherZoneCenter.z)
 				minDistance = 0; //zones on different levels can overlap completely
 			else
-				minDistance = (zone.second->getSize() + otherZone->getSize()) / mapSize; //scale down to (0,1) coordinates
+				minDistance = (layout.size[i] + layout.size[other]) / mapSize; //scale down to (0,1) coordinates
 
 			if (distance > minDistance)
 				totalDistance += (distance - minDistance);
 		}
-		distances[zone.second] = totalDistance;
-		forceVector.z = 0; //operator - doesn't preserve z coordinate :/
-		forces[zone.second] = forceVector;
+		layout.distances[i] = totalDistance;
+		layout.forceX[i] = forceVector.x;
+		layout.forceY[i] = forceVector.y;
 	}
 }
 
-void CZonePlacer::separateOverlappingZones(TZoneMap &zones, TForceVector &forces, TDistanceVector &overlaps)
+void CZonePlacer::separateOverlappingZones(ZoneLayout & layout) const
 {
-	for(const auto & zone : zones)
+	const size_t count = layout.count();
+	const float * xs = layout.x.data();
+	const float * ys = layout.y.data();
+	const si32 * zs = layout.z.data();
+	const int * sizes = layout.size.data();
+
+	std::vector<float> pairForceX(count);
+	std::vector<float> pairForceY(count);
+	std::vector<float> pairOverlap(count);
+
+	for(size_t i = 0; i < count; i++)
 	{
 		float3 forceVector(0, 0, 0);
-		float3 pos = zone.second->getCenter();
+		float3 pos = layout.getCenter(i);
+		const float * graphDistance = layout.graphDistance.data() + i * count;
+		const float * forceScale = layout.forceScale.data() + i * count;
 
-		float overlap = 0;
 		//separate overlapping zones
-		for(const auto & otherZone : zones)
+		//push of every other zone is computed independently of the others, so that this loop can be vectorized
+		for(size_t j = 0; j < count; j++)
 		{
-			float3 otherZoneCenter = otherZone.second->getCenter();
+			const double dx = pos.x - xs[j];
+			const double dy = pos.y - ys[j];
+			const auto distance = static_cast<float>(std::sqrt(dx * dx + dy * dy));
+			const float minDistance = (sizes[i] + sizes[j]) / mapSize;
+			const float push = (minDistance / (distance ? distance : 1e-3f));
+
 			//zones on different levels don't push away
-			if (zone == otherZone || pos.z != otherZoneCenter.z)
-				continue;
+			const bool overlapping = j != i && zs[j] == pos.z && distance < minDistance;
+			pairForceX[j] = overlapping ? (((xs[j] - pos.x) * push) / getDistance(distance)) * stifness * forceScale[j] * (graphDistance[j] / 2.0f) : 0.f; //negative value
+			pairForceY[j] = overlapping ? (((ys[j] - pos.y) * push) / getDistance(distance)) * stifness * forceScale[j] * (graphDistance[j] / 2.0f) : 0.f;
+			pairOverlap[j] = overlapping ? (minDistance - distance) : 0.f; //overlapping of small zones hurts us more
+		}
 
-			auto distance = static_cast<float>(pos.dist2d(otherZoneCenter));
-			float minDistance = (zone.second->getSize() + otherZone.second->getSize()) / mapSize;
-			if (distance < minDistance)
-			{
-				float3 localForce = (((otherZoneCenter - pos)*(minDistance / (distance ? distance : 1e-3f))) / getDistance(distance)) * stifness;
-				//negative value
-				localForce *= scaleForceBetweenZones(zone.second, otherZone.second);
-				forceVector -= localForce * (distancesBetweenZones[zone.second->getId()][otherZone.second->getId()] / 2.0f);
-				overlap += (minDistance - distance); //overlapping of small zones hurts us more
-			}
+		float overlap = 0;
+		for(size_t j = 0; j < count; j++)
+		{
+			forceVector.x -= pairForceX[j];
+			forceVector.y -= pairForceY[j];
+			overlap += pairOverlap[j];
 		}
 
 		//move zones away from boundaries
 		//do not scale boundary distance - zones tend to get squashed
-		float size = zone.second->getSize() / mapSize;
+		float size = layout.size[i] / mapSize;
 
 		auto pushAwayFromBoundary = [&forceVector, pos, size, &overlap, this](float x, float y)
 		{
@@ -656,60 +737,58 @@ void CZonePlacer::separateOverlappingZones(TZoneMap &zones, TForceVector &forces
 
 		//Always move repulsive zones away, no matter their distance
 		//TODO: Consider z plane?
-		for (auto& connection : zone.second->getConnections())
+		for (size_t other : layout.repulsed[i])
 		{
-			if (connection.getConnectionType() == rmg::EConnectionType::REPULSIVE)
-			{
-				auto & otherZone = zones[connection.getOtherZoneId(zone.second->getId())];
-				float3 otherZoneCenter = otherZone->getCenter();
-
-				//TODO: Roll into lambda?
-				auto distance = static_cast<float>(pos.dist2d(otherZoneCenter));
-				float minDistance = (zone.second->getSize() + otherZone->getSize()) / mapSize;
-				float3 localForce = (((otherZoneCenter - pos)*(minDistance / (distance ? distance : 1e-3f))) / getDistance(distance)) * stifness;
-				localForce *= (distancesBetweenZones[zone.second->getId()][otherZone->getId()]);
-				forceVector -= localForce * scaleForceBetweenZones(zone.second, otherZone);
-			}
+			float3 otherZoneCenter = layout.getCenter(other);
+
+			//TODO: Roll into lambda?
+			auto distance = static_cast<float>(pos.dist2d(otherZoneCenter));
+			float minDistance = (layout.size[i] + layout.size[other]) / mapSize;
+			float3 localForce = (((otherZoneCenter - pos)*(minDistance / (distance ? distance : 1e-3f))) / getDistance(distance)) * stifness;
+			localForce *= graphDistance[other];
+			forceVector -= localForce * forceScale[other];
 		}
 
-		overlaps[zone.second] = overlap;
-		forceVector.z = 0; //operator - doesn't preserve z coordinate :/
-		forces[zone.second] = forceVector;
+		layout.overlaps[i] = overlap;
+		layout.forceX[i] = forceVector.x;
+		layout.forceY[i] = forceVector.y;
 	}
 }
 
-void CZonePlacer::moveOneZone(TZoneMap& zones, TForceVector& totalForces, TDistanceVector& distances, TDistanceVector& overlaps)
+void CZonePlacer::moveOneZone(ZoneLayout & layout)
 {
+	const size_t count = layout.count();
+
 	//The more zones, the greater total distance expected
 	//Also, higher stiffness make expected movement lower
-	const int maxDistanceMovementRatio = zones.size() * zones.size() * (stiffnessConstant / stifness);
+	const int maxDistanceMovementRatio = count * count * (stiffnessConstant / stifness);
 
-	typedef std::pair<float, std::shared_ptr<Zone>> Misplacement;
+	typedef std::pair<float, size_t> Misplacement;
 	std::vector<Misplacement> misplacedZones;
 
 	float totalDistance = 0;
 	float totalOverlap = 0;
-	for (const auto& zone : distances) //find most misplaced zone
+	for (size_t i = 0; i < count; i++) //find most misplaced zone
 	{
-		if (vstd::contains(lastSwappedZones, zone.first->getId()))
+		if (vstd::contains(lastSwappedZones, layout.zones[i]->getId()))
 		{
 			continue;
 		}
-		totalDistance += zone.second;
-		float overlap = overlaps[zone.first];
+		totalDistance += layout.distances[i];
+		float overlap = layout.overlaps[i];
 		totalOverlap += overlap;
 		//if distance to actual movement is long, the zone is misplaced
-		float ratio = (zone.second + overlap) / static_cast<float>(totalForces[zone.first].mag());
+		float ratio = (layout.distances[i] + overlap) / static_cast<float>(float3(layout.totalForceX[i], layout.totalForceY[i], 0).mag());
 		if (ratio > maxDistanceMovementRatio)
 		{
-			misplacedZones.emplace_back(std::make_pair(ratio, zone.first));
+			misplacedZones.emplace_back(std::make_pair(ratio, i));
 		}
 	}
 
 	if (misplacedZones.empty())
 		return;
 
-	boost::sort(misplacedZones, [](const Misplacement& lhs, Misplacement& rhs)
+	boost::stable_sort(misplacedZones, [](const Misplacement& lhs, const Misplacement& rhs)
 	{
 		return lhs.first > rhs.first; //Largest displacement first
 	});
@@ -723,33 +802,21 @@ void CZonePlacer::moveOneZone(TZoneMap& zones, TForceVector& totalForces, TDista
 		//Swap 2 misplaced zones
 
 		auto firstZone = misplacedZones.front().second;
-		std::shared_ptr<Zone> secondZone;
+		std::optional<size_t> secondZone;
 		std::set<TRmgTemplateZoneId> connectedZones;
-		for (const auto& connection : firstZone->getConnections())
+		for (size_t other : layout.attracted[firstZone])
 		{
-			switch (connection.getConnectionType())
-			{
-				//Do not consider virtual connections for graph distance
-				case rmg::EConnectionType::REPULSIVE:
-				case rmg::EConnectionType::FORCE_PORTAL:
-					continue;
-			}
-			if (connection.getZoneA() == connection.getZoneB())
-			{
-				//Do not consider self-connections
-				continue;
-			}
-			connectedZones.insert(connection.getOtherZoneId(firstZone->getId()));
+			connectedZones.insert(layout.zones[other]->getId());
 		}
 
-		auto level = firstZone->getCenter().z;
+		auto level = layout.z[firstZone];
 		for (size_t i = 1; i < misplacedZones.size(); i++)
 		{
 			//Only swap zones on the same level
 			//Don't swap zones that should be connected (Jebus)
 
-			if (misplacedZones[i].second->getCenter().z == level &&
-				!vstd::contains(connectedZones, misplacedZones[i].second->getId()))
+			if (layout.z[misplacedZones[i].second] == level &&
+				!vstd::contains(connectedZones, layout.zones[misplacedZones[i].second]->getId()))
 			{
 				secondZone = misplacedZones[i].second;
 				break;
@@ -758,55 +825,60 @@ void CZonePlacer::moveOneZone(TZoneMap& zones, TForceVector& totalForces, TDista
 		if (secondZone)
 		{
 #ifdef ZONE_PLACEMENT_LOG
-			logGlobal->trace("Swapping two misplaced zones %d and %d", firstZone->getId(), secondZone->getId());
+			logGlobal->trace("Swapping two misplaced zones %d and %d", layout.zones[firstZone]->getId(), layout.zones[*secondZone]->getId());
 #endif
 
-			auto firstCenter = firstZone->getCenter();
-			auto secondCenter = secondZone->getCenter();
-			firstZone->setCenter(secondCenter);
-			secondZone->setCenter(firstCenter);
+			auto firstCenter = layout.getCenter(firstZone);
+			auto secondCenter = layout.getCenter(*secondZone);
+			layout.setCenter(firstZone, secondCenter);
+			layout.setCenter(*secondZone, firstCenter);
 
-			lastSwappedZones.insert(firstZone->getId());
-			lastSwappedZones.insert(secondZone->getId());
+			lastSwappedZones.insert(layout.zones[firstZone]->getId());
+			lastSwappedZones.insert(layout.zones[*secondZone]->getId());
 			return;
 		}
 	}
 	lastSwappedZones.clear(); //If we didn't swap zones in this iteration, we can do it in the next
 
 	//find most distant zone that should be attracted and move inside it
-	std::shared_ptr<Zone> targetZone;
+	std::optional<size_t> targetZone;
 	auto misplacedZone = misplacedZones.front().second;
-	float3 ourCenter = misplacedZone->getCenter();
+	float3 ourCenter = layout.getCenter(misplacedZone);
 		
 	if ((totalDistance / (bestTotalDistance + 1)) > (totalOverlap / (bestTotalOverlap + 1)))
 	{
 		//Move one zone towards most distant zone to reduce distance
 
 		float maxDistance = 0;
-		for (auto con : misplacedZone->getConnections())
+		for (auto con : layout.zones[misplacedZone]->getConnections())
 		{
 			if (con.getConnectionType() == rmg::EConnectionType::REPULSIVE)
 			{
 				continue;
 			}
 
-			auto otherZone = zones[con.getOtherZoneId(misplacedZone->getId())];
-			float distance = static_cast<float>(otherZone->getCenter().dist2dSQ(ourCenter));
+			auto otherZone = layout.indexById.find(con.getOtherZoneId(layout.zones[misplacedZone]->getId()));
+			if (otherZone == layout.indexById.end())
+			{
+				continue;
+			}
+			float distance = static_cast<float>(layout.getCenter(otherZone->second).dist2dSQ(ourCenter));
 			if (distance > maxDistance)
 			{
 				maxDistance = distance;
-				targetZone = otherZone;
+				targetZone = otherZone->second;
 			}
 		}
 		if (targetZone)
 		{
-			float3 vec = targetZone->getCenter() - ourCenter;
-			float newDistanceBetweenZones = (std::max(misplacedZone->getSize(), targetZone->getSize())) / mapSize;
+			float3 targetCenter = layout.getCenter(*targetZone);
+			float3 vec = targetCenter - ourCenter;
+			float newDistanceBetweenZones = (std::max(layout.size[misplacedZone], layout.size[*targetZone])) / mapSize;
 #ifdef ZONE_PLACEMENT_LOG
-			logGlobal->trace("Trying to move zone %d %s towards %d %s. Direction is %s", misplacedZone->getId(), ourCenter.toString(), targetZone->getId(), targetZone->getCenter().toString(), vec.toString());
+			logGlobal->trace("Trying to move zone %d %s towards %d %s. Direction is %s", layout.zones[misplacedZone]->getId(), ourCenter.toString(), layout.zones[*targetZone]->getId(), targetCenter.toString(), vec.toString());
 #endif
 
-			misplacedZone->setCenter(targetZone->getCenter() - vec.unitVector() * newDistanceBetweenZones); //zones should now overlap by half size
+			layout.setCenter(misplacedZone, targetCenter - vec.unitVector() * newDistanceBetweenZones); //zones should now overlap by half size
 		}
 	}
 	else
@@ -814,33 +886,34 @@ void CZonePlacer::moveOneZone(TZoneMap& zones, TForceVector& totalForces, TDista
 		//Move misplaced zone away from overlapping zone
 
 		float maxOverlap = 0;
-		for(const auto & otherZone : zones)
+		for(size_t other = 0; other < count; other++)
 		{
-			float3 otherZoneCenter = otherZone.second->getCenter();
+			float3 otherZoneCenter = layout.getCenter(other);
 
-			if (otherZone.second == misplacedZone || otherZoneCenter.z != ourCenter.z)
+			if (other == misplacedZone || otherZoneCenter.z != ourCenter.z)
 				continue;
 
 			auto distance = static_cast<float>(otherZoneCenter.dist2dSQ(ourCenter));
 			if (distance > maxOverlap)
 			{
 				maxOverlap = distance;
-				targetZone = otherZone.second;
+				targetZone = other;
 			}
 		}
 		if (targetZone)
 		{
-			float3 vec = ourCenter - targetZone->getCenter();
-			float newDistanceBetweenZones = (misplacedZone->getSize() + targetZone->getSize()) / mapSize;
+			float3 targetCenter = layout.getCenter(*targetZone);
+			float3 vec = ourCenter - targetCenter;
+			float newDistanceBetweenZones = (layout.size[misplacedZone] + layout.size[*targetZone]) / mapSize;
 #ifdef ZONE_PLACEMENT_LOG
-			logGlobal->trace("Trying to move zone %d %s away from %d %s. Direction is %s", misplacedZone->getId(), ourCenter.toString(), targetZone->getId(), targetZone->getCenter().toString(), vec.toString());
+			logGlobal->trace("Trying to move zone %d %s away from %d %s. Direction is %s", layout.zones[misplacedZone]->getId(), ourCenter.toString(), layout.zones[*targetZone]->getId(), targetCenter.toString(), vec.toString());
 #endif
 
-			misplacedZone->setCenter(targetZone->getCenter() + vec.unitVector() * newDistanceBetweenZones); //zones should now be just separated
+			layout.setCenter(misplacedZone, targetCenter + vec.unitVector() * newDistanceBetweenZones); //zones should now be just separated
 		}
 	}
 	//Don't swap that zone in next iteration
-	lastSwappedZones.insert(misplacedZone->getId());
+	lastSwappedZones.insert(layout.zones[misplacedZone]->getId());
 }
 
 float CZonePlacer::metric (const int3 &A, const int3 &B) const
@@ -28,8 +28,6 @@ class Zone;
 
 typedef std::vector<std::pair<TRmgTemplateZoneId, std::shared_ptr<Zone>>> TZoneVector;
 typedef std::map<TRmgTemplateZoneId, std::shared_ptr<Zone>> TZoneMap;
-typedef std::map<std::shared_ptr<Zone>, float3> TForceVector;
-typedef std::map<std::shared_ptr<Zone>, float> TDistanceVector;
 typedef std::map<int, std::map<int, size_t>> TDistanceMap;
 
 class CZonePlacer
@@ -50,10 +48,48 @@ public:
 	const TDistanceMap & getDistanceMap();
 	
 private:
+	/// State of force-directed placement, kept in contiguous arrays indexed by zone (in order of zone id)
+	struct ZoneLayout
+	{
+		std::vector<std::shared_ptr<Zone>> zones;
+		std::map<TRmgTemplateZoneId, size_t> indexById;
+
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<si32> z;
+		std::vector<int> size;
+
+		std::vector<float> forceX;
+		std::vector<float> forceY;
+		std::vector<float> totalForceX;
+		std::vector<float> totalForceY;
+		std::vector<float> distances;
+		std::vector<float> overlaps;
+
+		/// Pairwise tables [a * count + b]: graph distance between zones and player separation factor
+		std::vector<float> graphDistance;
+		std::vector<float> forceScale;
+
+		/// Attracting and repulsive connections of each zone, as indexes of other zones
+		std::vector<std::vector<size_t>> attracted;
+		std::vector<std::vector<size_t>> repulsed;
+
+		size_t count() const
+		{
+			return zones.size();
+		}
+		float3 getCenter(size_t zone) const
+		{
+			return float3(x[zone], y[zone], z[zone]);
+		}
+		void setCenter(size_t zone, const float3 & center);
+	};
+
 	void prepareZones(TZoneMap &zones, TZoneVector &zonesVector, const bool underground, vstd::RNG * rand);
-	void attractConnectedZones(TZoneMap & zones, TForceVector & forces, TDistanceVector & distances) const;
-	void separateOverlappingZones(TZoneMap &zones, TForceVector &forces, TDistanceVector &overlaps);
-	void moveOneZone(TZoneMap & zones, TForceVector & totalForces, TDistanceVector & distances, TDistanceVector & overlaps);
+	void prepareLayout(const TZoneMap & zones, ZoneLayout & layout) const;
+	void attractConnectedZones(ZoneLayout & layout) const;
+	void separateOverlappingZones(ZoneLayout & layout) const;
+	void moveOneZone(ZoneLayout & layout);
 
 private:
 	int width;
@@ -12,6 +12,10 @@
 #include "RmgArea.h"
 #include "CMapGenerator.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 VCMI_LIB_NAMESPACE_BEGIN
 
 namespace rmg
@@ -32,168 +36,390 @@ void toRelative(Tileset & tiles, const int3 & position)
 	toAbsolute(tiles, -position);
 }
 
-Area::Area(const Area & area): dTiles(area.dTiles), dTotalShiftCache(area.dTotalShiftCache)
+namespace
+{
+	constexpr int WORD_BITS = 64;
+
+	int floorDiv(int value, int divisor)
+	{
+		return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+	}
+
+	int lowestBit(uint64_t word)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, word);
+		return static_cast<int>(index);
+#else
+		return __builtin_ctzll(word);
+#endif
+	}
+
+	/// 64 bits of row starting at given bit offset, bits outside of row are empty
+	uint64_t extractBits(const uint64_t * row, int words, int offset)
+	{
+		if(!row)
+			return 0;
+
+		int word = floorDiv(offset, WORD_BITS);
+		int shift = offset - word * WORD_BITS;
+		auto at = [row, words](int index) -> uint64_t
+		{
+			return index >= 0 && index < words ? row[index] : 0;
+		};
+
+		if(shift == 0)
+			return at(word);
+		return (at(word) >> shift) | (at(word + 1) << (WORD_BITS - shift));
+	}
+}
+
+Area::Area(const Area & area):
+	origin(area.origin),
+	wordsPerRow(area.wordsPerRow),
+	rows(area.rows),
+	levels(area.levels),
+	bits(area.bits)
 {
 }
 
-Area::Area(Area && area) noexcept: dTiles(std::move(area.dTiles)), dTotalShiftCache(area.dTotalShiftCache)
+Area::Area(Area && area) noexcept:
+	origin(area.origin),
+	wordsPerRow(area.wordsPerRow),
+	rows(area.rows),
+	levels(area.levels),
+	bits(std::move(area.bits)),
+	dTilesCache(std::move(area.dTilesCache)),
+	dTilesVectorCache(std::move(area.dTilesVectorCache)),
+	dBorderCache(std::move(area.dBorderCache)),
+	dBorderOutsideCache(std::move(area.dBorderOutsideCache))
 {
+	area.clear();
 }
 
+Area::~Area() = default;
+
 Area & Area::operator=(const Area & area)
 {
-	clear();
-	dTiles = area.dTiles;
-	dTotalShiftCache = area.dTotalShiftCache;
+	if(this == &area)
+		return *this;
+
+	invalidate();
+	origin = area.origin;
+	wordsPerRow = area.wordsPerRow;
+	rows = area.rows;
+	levels = area.levels;
+	bits = area.bits;
 	return *this;
 }
 
-Area::Area(Tileset tiles): dTiles(std::move(tiles))
+Area & Area::operator=(Area && area) noexcept
 {
+	if(this == &area)
+		return *this;
+
+	origin = area.origin;
+	wordsPerRow = area.wordsPerRow;
+	rows = area.rows;
+	levels = area.levels;
+	bits = std::move(area.bits);
+	dTilesCache = std::move(area.dTilesCache);
+	dTilesVectorCache = std::move(area.dTilesVectorCache);
+	dBorderCache = std::move(area.dBorderCache);
+	dBorderOutsideCache = std::move(area.dBorderOutsideCache);
+	area.clear();
+	return *this;
 }
 
-Area::Area(Tileset relative, const int3 & position): dTiles(std::move(relative)), dTotalShiftCache(position)
+Area::Area(const Tileset & tiles)
 {
+	assign(tiles);
+}
+
+Area::Area(const Tileset & relative, const int3 & position)
+{
+	assign(relative);
+	translate(position);
 }
 
 void Area::invalidate()
 {
-	getTiles();
+	dTilesCache.clear();
 	dTilesVectorCache.clear();
-	dBorderCache.clear();
-	dBorderOutsideCache.clear();
+	dBorderCache.reset();
+	dBorderOutsideCache.reset();
 }
 
-bool Area::connected(bool noDiagonals) const
+Area::Word * Area::row(int y, int z)
+{
+	return const_cast<Word *>(static_cast<const Area *>(this)->row(y, z));
+}
+
+const Area::Word * Area::row(int y, int z) const
+{
+	if(y < origin.y || y >= origin.y + rows || z < origin.z || z >= origin.z + levels)
+		return nullptr;
+
+	return bits.data() + ((z - origin.z) * rows + (y - origin.y)) * wordsPerRow;
+}
+
+Area::Word Area::extract(const Area & source, int y, int z, int word, int dx, int dy) const
 {
-	std::list<int3> queue({*dTiles.begin()});
-	Tileset connected = dTiles; //use invalidated cache - ok
+	return extractBits(source.row(y + dy, z), source.wordsPerRow, origin.x + word * WORD_BITS + dx - source.origin.x);
+}
+
+void Area::copyBounds(const Area & area)
+{
+	origin = area.origin;
+	wordsPerRow = area.wordsPerRow;
+	rows = area.rows;
+	levels = area.levels;
+	bits.assign(area.bits.size(), 0);
+}
+
+void Area::fit(const int3 & minTile, const int3 & maxTile, bool reserve)
+{
+	if(bits.empty())
+	{
+		origin = minTile;
+		wordsPerRow = (maxTile.x - minTile.x) / WORD_BITS + 1;
+		rows = maxTile.y - minTile.y + 1;
+		levels = maxTile.z - minTile.z + 1;
+		bits.assign(wordsPerRow * rows * levels, 0);
+		return;
+	}
+
+	int3 oldMax(origin.x + wordsPerRow * WORD_BITS - 1, origin.y + rows - 1, origin.z + levels - 1);
+	int3 newMin(std::min(origin.x, minTile.x), std::min(origin.y, minTile.y), std::min(origin.z, minTile.z));
+	int3 newMax(std::max(oldMax.x, maxTile.x), std::max(oldMax.y, maxTile.y), std::max(oldMax.z, maxTile.z));
+
+	if(newMin == origin && newMax == oldMax)
+		return;
 
-	while(!queue.empty())
+	if(reserve)
 	{
-		auto t = queue.front();
-		connected.erase(t);
-		queue.pop_front();
-		
-		if (noDiagonals)
+		//tiles are usually added one by one in the same direction, leave space for more
+		if(newMin.x < origin.x)
+			newMin.x -= WORD_BITS / 2;
+		if(newMin.y < origin.y)
+			newMin.y -= std::max(2, rows / 2);
+		if(newMax.y > oldMax.y)
+			newMax.y += std::max(2, rows / 2);
+	}
+
+	Area grown;
+	grown.fit(newMin, newMax, false);
+
+	for(int z = origin.z; z < origin.z + levels; z++)
+	{
+		for(int y = origin.y; y < origin.y + rows; y++)
 		{
-			for (auto& i : dirs4)
-			{
-				if (connected.count(t + i))
-				{
-					queue.push_back(t + i);
-				}
-			}
+			auto * target = grown.row(y, z);
+			for(int w = 0; w < grown.wordsPerRow; w++)
+				target[w] = grown.extract(*this, y, z, w, 0, 0);
 		}
-		else
+	}
+
+	origin = grown.origin;
+	wordsPerRow = grown.wordsPerRow;
+	rows = grown.rows;
+	levels = grown.levels;
+	bits = std::move(grown.bits);
+}
+
+bool Area::firstTile(int3 & tile) const
+{
+	for(size_t i = 0; i < bits.size(); i++)
+	{
+		if(bits[i])
 		{
-			for (auto& i : int3::getDirs())
-			{
-				if (connected.count(t + i))
-				{
-					queue.push_back(t + i);
-				}
-			}
+			int rowIndex = static_cast<int>(i) / wordsPerRow;
+			int word = static_cast<int>(i) % wordsPerRow;
+			tile = int3(origin.x + word * WORD_BITS + lowestBit(bits[i]), origin.y + rowIndex % rows, origin.z + rowIndex / rows);
+			return true;
 		}
 	}
-	
-	return connected.empty();
+	return false;
 }
 
-std::list<Area> connectedAreas(const Area & area, bool disableDiagonalConnections)
+Area Area::floodFill(const int3 & start, bool noDiagonals) const
 {
-	auto allDirs = int3::getDirs();
-	std::vector<int3> dirs(allDirs.begin(), allDirs.end());
-	if(disableDiagonalConnections)
-		dirs.assign(rmg::dirs4.begin(), rmg::dirs4.end());
-	
-	std::list<Area> result;
-	Tileset connected = area.getTiles();
-	while(!connected.empty())
+	Area component;
+	component.copyBounds(*this);
+	component.add(start);
+
+	//neighbours are on the same level, so only rows around already reached ones can grow
+	int z = start.z;
+	int minY = start.y;
+	int maxY = start.y;
+	bool changed = true;
+
+	while(changed)
 	{
-		result.emplace_back();
-		std::list<int3> queue({*connected.begin()});
-		std::set<int3> queueSet({*connected.begin()});
-		while(!queue.empty())
+		changed = false;
+		int fromY = std::max(minY - 1, origin.y);
+		int toY = std::min(maxY + 1, origin.y + rows - 1);
+
+		for(int y = fromY; y <= toY; y++)
 		{
-			auto t = queue.front();
-			connected.erase(t);
-			result.back().add(t);
-			queue.pop_front();
-			
-			for(auto & i : dirs)
+			const auto * mask = row(y, z);
+			auto * reached = component.row(y, z);
+
+			for(int w = 0; w < wordsPerRow; w++)
 			{
-				auto tile = t + i;
-				if(!queueSet.count(tile) && connected.count(tile) && !result.back().contains(tile))
+				Word grown = reached[w]
+					| component.extract(component, y, z, w, -1, 0)
+					| component.extract(component, y, z, w, 1, 0)
+					| component.extract(component, y, z, w, 0, -1)
+					| component.extract(component, y, z, w, 0, 1);
+
+				if(!noDiagonals)
+				{
+					grown |= component.extract(component, y, z, w, -1, -1)
+						| component.extract(component, y, z, w, 1, -1)
+						| component.extract(component, y, z, w, -1, 1)
+						| component.extract(component, y, z, w, 1, 1);
+				}
+
+				grown &= mask[w];
+				if(grown != reached[w])
 				{
-					queueSet.insert(tile);
-					queue.push_back(tile);
+					reached[w] = grown;
+					changed = true;
+					minY = std::min(minY, y);
+					maxY = std::max(maxY, y);
 				}
 			}
 		}
 	}
+
+	//keep only rows which were reached
+	Area result;
+	result.fit(int3(origin.x, minY, z), int3(origin.x + wordsPerRow * WORD_BITS - 1, maxY, z), false);
+	for(int y = minY; y <= maxY; y++)
+		std::copy_n(component.row(y, z), wordsPerRow, result.row(y, z));
+
+	return result;
+}
+
+bool Area::connected(bool noDiagonals) const
+{
+	int3 start;
+	if(!firstTile(start))
+		return true;
+
+	auto component = floodFill(start, noDiagonals);
+	return component.contains(*this);
+}
+
+std::list<Area> connectedAreas(const Area & area, bool disableDiagonalConnections)
+{
+	std::list<Area> result;
+	Area remaining(area);
+	int3 start;
+
+	while(remaining.firstTile(start))
+	{
+		result.push_back(remaining.floodFill(start, disableDiagonalConnections));
+		remaining.subtract(result.back());
+	}
 	return result;
 }
 
 const Tileset & Area::getTiles() const
 {
-	if(dTotalShiftCache != int3())
+	if(dTilesCache.empty())
 	{
-		toAbsolute(dTiles, dTotalShiftCache);
-		dTotalShiftCache = int3();
+		const auto & vec = getTilesVector();
+		dTilesCache.reserve(vec.size());
+		dTilesCache.insert(vec.begin(), vec.end());
 	}
-	return dTiles;
+	return dTilesCache;
 }
 
 const std::vector<int3> & Area::getTilesVector() const
 {
 	if(dTilesVectorCache.empty())
 	{
-		getTiles();
-		dTilesVectorCache.assign(dTiles.begin(), dTiles.end());
+		for(int z = 0; z < levels; z++)
+		{
+			for(int y = 0; y < rows; y++)
+			{
+				const auto * tiles = row(origin.y + y, origin.z + z);
+				for(int w = 0; w < wordsPerRow; w++)
+				{
+					for(Word word = tiles[w]; word; word &= word - 1)
+						dTilesVectorCache.emplace_back(origin.x + w * WORD_BITS + lowestBit(word), origin.y + y, origin.z + z);
+				}
+			}
+		}
 	}
 	return dTilesVectorCache;
 }
 
-const Tileset & Area::getBorder() const
+const Area & Area::getBorder() const
 {
-	if(!dBorderCache.empty())
-		return dBorderCache;
-	
-	//compute border cache
-	dBorderCache.reserve(dTiles.bucket_count());
-	for(const auto & t : dTiles)
+	if(dBorderCache)
+		return *dBorderCache;
+
+	//tiles which miss at least one of 8 neighbours
+	dBorderCache = std::make_unique<Area>();
+	auto & border = *dBorderCache;
+	border.copyBounds(*this);
+
+	for(int z = origin.z; z < origin.z + levels; z++)
 	{
-		for(auto & i : int3::getDirs())
+		for(int y = origin.y; y < origin.y + rows; y++)
 		{
-			if(!dTiles.count(t + i))
+			const auto * tiles = row(y, z);
+			auto * target = border.row(y, z);
+
+			for(int w = 0; w < wordsPerRow; w++)
 			{
-				dBorderCache.insert(t + dTotalShiftCache);
-				break;
+				Word interior = tiles[w];
+				for(const auto & dir : int3::getDirs())
+					interior &= extract(*this, y, z, w, dir.x, dir.y);
+
+				target[w] = tiles[w] & ~interior;
 			}
 		}
 	}
-	
-	return dBorderCache;
+
+	return border;
 }
 
-const Tileset & Area::getBorderOutside() const
+const Area & Area::getBorderOutside() const
 {
-	if(!dBorderOutsideCache.empty())
-		return dBorderOutsideCache;
-	
-	//compute outside border cache
-	dBorderOutsideCache.reserve(dBorderCache.bucket_count() * 2);
-	for(const auto & t : dTiles)
+	if(dBorderOutsideCache)
+		return *dBorderOutsideCache;
+
+	//tiles outside of area which have at least one of 8 neighbours inside
+	dBorderOutsideCache = std::make_unique<Area>();
+	auto & border = *dBorderOutsideCache;
+	if(bits.empty())
+		return border;
+
+	border.fit(origin - int3(1, 1, 0), origin + int3(wordsPerRow * WORD_BITS, rows, levels - 1), false);
+
+	for(int z = border.origin.z; z < border.origin.z + border.levels; z++)
 	{
-		for(auto & i : int3::getDirs())
+		for(int y = border.origin.y; y < border.origin.y + border.rows; y++)
 		{
-			if(!dTiles.count(t + i))
-				dBorderOutsideCache.insert(t + i + dTotalShiftCache);
+			auto * target = border.row(y, z);
+
+			for(int w = 0; w < border.wordsPerRow; w++)
+			{
+				Word neighbours = 0;
+				for(const auto & dir : int3::getDirs())
+					neighbours |= border.extract(*this, y, z, w, dir.x, dir.y);
+
+				target[w] = neighbours & ~border.extract(*this, y, z, w, 0, 0);
+			}
 		}
 	}
-	
-	return dBorderOutsideCache;
+
+	return border;
 }
 
 DistanceMap Area::computeDistanceMap(std::map<int, Tileset> & reverseDistanceMap) const
@@ -205,22 +431,34 @@ DistanceMap Area::computeDistanceMap(std::map<int, Tileset> & reverseDistanceMap
 	
 	while(!area.empty())
 	{
-		for(const auto & tile : area.getBorder())
+		Area border = area.getBorder();
+		for(const auto & tile : border.getTilesVector())
 			result[tile] = distance;
-		reverseDistanceMap[distance++] = area.getBorder();
-		area.subtract(area.getBorder());
+		reverseDistanceMap[distance++] = border.getTiles();
+		area.subtract(border);
 	}
 	return result;
 }
 
 bool Area::empty() const
 {
-	return dTiles.empty();
+	if(!dTilesVectorCache.empty())
+		return false;
+
+	return std::all_of(bits.begin(), bits.end(), [](Word word)
+	{
+		return word == 0;
+	});
 }
 
 bool Area::contains(const int3 & tile) const
 {
-	return dTiles.count(tile - dTotalShiftCache);
+	int x = tile.x - origin.x;
+	if(x < 0 || x >= wordsPerRow * WORD_BITS)
+		return false;
+
+	const auto * tiles = row(tile.y, tile.z);
+	return tiles && ((tiles[x / WORD_BITS] >> (x % WORD_BITS)) & 1);
 }
 
 bool Area::contains(const std::vector<int3> & tiles) const
@@ -235,12 +473,23 @@ bool Area::contains(const std::vector<int3> & tiles) const
 
 bool Area::contains(const Area & area) const
 {
-	return contains(area.getTilesVector());
+	for(int z = area.origin.z; z < area.origin.z + area.levels; z++)
+	{
+		for(int y = area.origin.y; y < area.origin.y + area.rows; y++)
+		{
+			const auto * tiles = area.row(y, z);
+			for(int w = 0; w < area.wordsPerRow; w++)
+			{
+				if(tiles[w] & ~area.extract(*this, y, z, w, 0, 0))
+					return false;
+			}
+		}
+	}
+	return true;
 }
 
 bool Area::overlap(const std::vector<int3> & tiles) const
 {
-	// Important: Make sure that tiles.size < area.size
 	for(const auto & t : tiles)
 	{
 		if(contains(t))
@@ -251,7 +500,22 @@ bool Area::overlap(const std::vector<int3> & tiles) const
 
 bool Area::overlap(const Area & area) const
 {
-	return overlap(area.getTilesVector());
+	for(int z = area.origin.z; z < area.origin.z + area.levels; z++)
+	{
+		for(int y = area.origin.y; y < area.origin.y + area.rows; y++)
+		{
+			if(!row(y, z))
+				continue;
+
+			const auto * tiles = area.row(y, z);
+			for(int w = 0; w < area.wordsPerRow; w++)
+			{
+				if(tiles[w] & area.extract(*this, y, z, w, 0, 0))
+					return true;
+			}
+		}
+	}
+	return false;
 }
 
 int Area::distance(const int3 & tile) const
@@ -301,92 +565,149 @@ int3 Area::nearest(const Area & area) const
 	return nearTile;
 }
 
+bool Area::getBoundingBox(int3 & minTile, int3 & maxTile) const
+{
+	if(bits.empty())
+		return false;
+
+	minTile = origin;
+	maxTile = origin + int3(wordsPerRow * WORD_BITS - 1, rows - 1, levels - 1);
+	return true;
+}
+
 Area Area::getSubarea(const std::function<bool(const int3 &)> & filter) const
 {
 	Area subset;
-	subset.dTiles.reserve(getTilesVector().size());
-	vstd::copy_if(getTilesVector(), vstd::set_inserter(subset.dTiles), filter);
+	subset.copyBounds(*this);
+	for(const auto & tile : getTilesVector())
+	{
+		if(filter(tile))
+			subset.add(tile);
+	}
 	return subset;
 }
 
 void Area::clear()
 {
-	dTiles.clear();
-	dTilesVectorCache.clear();
-	dTotalShiftCache = int3();
 	invalidate();
+	origin = int3();
+	wordsPerRow = 0;
+	rows = 0;
+	levels = 0;
+	bits.clear();
 }
 
-void Area::assign(const Tileset tiles)
+void Area::assign(const Tileset & tiles)
 {
 	clear();
-	dTiles = tiles;
+	if(tiles.empty())
+		return;
+
+	int3 minTile = *tiles.begin();
+	int3 maxTile = minTile;
+	for(const auto & tile : tiles)
+	{
+		minTile = int3(std::min(minTile.x, tile.x), std::min(minTile.y, tile.y), std::min(minTile.z, tile.z));
+		maxTile = int3(std::max(maxTile.x, tile.x), std::max(maxTile.y, tile.y), std::max(maxTile.z, tile.z));
+	}
+
+	fit(minTile, maxTile, false);
+	for(const auto & tile : tiles)
+		add(tile);
 }
 
 void Area::add(const int3 & tile)
 {
 	invalidate();
-	dTiles.insert(tile);
+	fit(tile, tile, true);
+
+	int x = tile.x - origin.x;
+	row(tile.y, tile.z)[x / WORD_BITS] |= Word(1) << (x % WORD_BITS);
 }
 
 void Area::erase(const int3 & tile)
 {
+	if(!contains(tile))
+		return;
+
 	invalidate();
-	dTiles.erase(tile);
+	int x = tile.x - origin.x;
+	row(tile.y, tile.z)[x / WORD_BITS] &= ~(Word(1) << (x % WORD_BITS));
 }
+
 void Area::unite(const Area & area)
 {
+	if(area.bits.empty())
+		return;
+
 	invalidate();
-	const auto & vec = area.getTilesVector();
-	dTiles.reserve(dTiles.size() + vec.size());
-	dTiles.insert(vec.begin(), vec.end());
+	fit(area.origin, area.origin + int3(area.wordsPerRow * WORD_BITS - 1, area.rows - 1, area.levels - 1), false);
+
+	for(int z = area.origin.z; z < area.origin.z + area.levels; z++)
+	{
+		for(int y = area.origin.y; y < area.origin.y + area.rows; y++)
+		{
+			auto * tiles = row(y, z);
+			for(int w = 0; w < wordsPerRow; w++)
+				tiles[w] |= extract(area, y, z, w, 0, 0);
+		}
+	}
 }
 
 void Area::intersect(const Area & area)
 {
 	invalidate();
-	Tileset result;
-	result.reserve(std::max(dTiles.size(), area.getTilesVector().size()));
-	for(const auto & t : area.getTilesVector())
+	for(int z = origin.z; z < origin.z + levels; z++)
 	{
-		if(dTiles.count(t))
-			result.insert(t);
+		for(int y = origin.y; y < origin.y + rows; y++)
+		{
+			auto * tiles = row(y, z);
+			for(int w = 0; w < wordsPerRow; w++)
+				tiles[w] &= extract(area, y, z, w, 0, 0);
+		}
 	}
-	dTiles = result;
 }
 
 void Area::subtract(const Area & area)
 {
 	invalidate();
-	for(const auto & t : area.getTilesVector())
+	for(int z = std::max(origin.z, area.origin.z); z < std::min(origin.z + levels, area.origin.z + area.levels); z++)
 	{
-		dTiles.erase(t);
+		for(int y = std::max(origin.y, area.origin.y); y < std::min(origin.y + rows, area.origin.y + area.rows); y++)
+		{
+			auto * tiles = row(y, z);
+			for(int w = 0; w < wordsPerRow; w++)
+				tiles[w] &= ~extract(area, y, z, w, 0, 0);
+		}
 	}
 }
 
 void Area::translate(const int3 & shift)
 {
-	dBorderCache.clear();
-	dBorderOutsideCache.clear();
+	//only bounding box moves, caches can be moved as well
+	origin += shift;
+	dTilesCache.clear();
 
-	if(dTilesVectorCache.empty())
-	{
-		getTilesVector();
-	}
-	
-	//avoid recomputation within std::set, use vector instead
-	dTotalShiftCache += shift;
-	
 	for(auto & t : dTilesVectorCache)
 	{
 		t += shift;
 	}
+
+	if(dBorderCache)
+		dBorderCache->translate(shift);
+	if(dBorderOutsideCache)
+		dBorderOutsideCache->translate(shift);
 }
 
 void Area::erase_if(std::function<bool(const int3&)> predicate)
 {
+	auto tiles = getTilesVector();
+	for(const auto & tile : tiles)
+	{
+		if(predicate(tile))
+			erase(tile);
+	}
 	invalidate();
-	vstd::erase_if(dTiles, predicate);
 }
 
 Area operator- (const Area & l, const int3 & r)
@@ -405,12 +726,8 @@ Area operator+ (const Area & l, const int3 & r)
 
 Area operator+ (const Area & l, const Area & r)
 {
-	Area result;
-	const auto & lTiles = l.getTilesVector();
-	const auto & rTiles = r.getTilesVector();
-	result.dTiles.reserve(lTiles.size() + rTiles.size());
-	result.dTiles.insert(lTiles.begin(), lTiles.end());
-	result.dTiles.insert(rTiles.begin(), rTiles.end());
+	Area result(l);
+	result.unite(r);
 	return result;
 }
 
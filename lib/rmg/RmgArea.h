@@ -25,20 +25,24 @@ namespace rmg
 	void toAbsolute(Tileset & tiles, const int3 & position);
 	void toRelative(Tileset & tiles, const int3 & position);
 	
+	/// Set of tiles, stored as bitmap over its bounding box with 64 tiles per word.
+	/// Set operations, borders and flood fills are done on whole words
 	class DLL_LINKAGE Area
 	{
 	public:
 		Area() = default;
 		Area(const Area &);
 		Area(Area &&) noexcept;
-		Area(Tileset tiles);
-		Area(Tileset relative, const int3 & position); //create from relative positions
+		Area(const Tileset & tiles);
+		Area(const Tileset & relative, const int3 & position); //create from relative positions
+		~Area();
 		Area & operator= (const Area &);
+		Area & operator= (Area &&) noexcept;
 		
-		const Tileset & getTiles() const;
-		const std::vector<int3> & getTilesVector() const;
-		const Tileset & getBorder() const; //lazy cache invalidation
-		const Tileset & getBorderOutside() const; //lazy cache invalidation
+		const Tileset & getTiles() const; //lazy cache
+		const std::vector<int3> & getTilesVector() const; //lazy cache, ordered by level, row and column
+		const Area & getBorder() const; //lazy cache invalidation
+		const Area & getBorderOutside() const; //lazy cache invalidation
 		
 		DistanceMap computeDistanceMap(std::map<int, Tileset> & reverseDistanceMap) const;
 
@@ -56,9 +60,10 @@ namespace rmg
 		int distanceSqr(const Area & area) const;
 		int3 nearest(const int3 & tile) const;
 		int3 nearest(const Area & area) const;
+		bool getBoundingBox(int3 & minTile, int3 & maxTile) const; //may be larger than tiles, false if empty
 		
 		void clear();
-		void assign(const Tileset tiles); //do not use reference to allow assignment of cached data
+		void assign(const Tileset & tiles);
 		void add(const int3 & tile);
 		void erase(const int3 & tile);
 		void unite(const Area & area);
@@ -67,25 +72,36 @@ namespace rmg
 		void translate(const int3 & shift);
 		void erase_if(std::function<bool(const int3&)> predicate);
 		
-		friend Area operator+ (const Area & l, const int3 & r); //translation
-		friend Area operator- (const Area & l, const int3 & r); //translation
-		friend Area operator+ (const Area & l, const Area & r); //union
-		friend Area operator* (const Area & l, const Area & r); //intersection
-		friend Area operator- (const Area & l, const Area & r); //AreaL reduced by tiles from AreaR
-		friend bool operator== (const Area & l, const Area & r);
-		friend std::list<Area> connectedAreas(const Area & area, bool disableDiagonalConnections);
+		friend DLL_LINKAGE Area operator+ (const Area & l, const int3 & r); //translation
+		friend DLL_LINKAGE Area operator- (const Area & l, const int3 & r); //translation
+		friend DLL_LINKAGE Area operator+ (const Area & l, const Area & r); //union
+		friend DLL_LINKAGE Area operator* (const Area & l, const Area & r); //intersection
+		friend DLL_LINKAGE Area operator- (const Area & l, const Area & r); //AreaL reduced by tiles from AreaR
+		friend DLL_LINKAGE bool operator== (const Area & l, const Area & r);
+		friend DLL_LINKAGE std::list<Area> connectedAreas(const Area & area, bool disableDiagonalConnections);
 		
 	private:
-		
+		using Word = uint64_t;
+
 		void invalidate();
-		void computeBorderCache();
-		void computeBorderOutsideCache();
+		void fit(const int3 & minTile, const int3 & maxTile, bool reserve); //grow bounding box to include given tiles
+		void copyBounds(const Area & area); //same bounding box, no tiles
+		Word * row(int y, int z);
+		const Word * row(int y, int z) const;
+		Word extract(const Area & source, int y, int z, int word, int dx, int dy) const; //tiles of source shifted by (dx, dy) under given word of this area
+		bool firstTile(int3 & tile) const;
+		Area floodFill(const int3 & start, bool noDiagonals) const;
 		
-		mutable Tileset dTiles;
+		int3 origin; //position of the first bit
+		int wordsPerRow = 0;
+		int rows = 0; //per level
+		int levels = 0;
+		std::vector<Word> bits;
+
+		mutable Tileset dTilesCache;
 		mutable std::vector<int3> dTilesVectorCache;
-		mutable Tileset dBorderCache;
-		mutable Tileset dBorderOutsideCache;
-		mutable int3 dTotalShiftCache;
+		mutable std::unique_ptr<Area> dBorderCache;
+		mutable std::unique_ptr<Area> dBorderOutsideCache;
 	};
 }
 
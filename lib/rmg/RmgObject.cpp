@@ -467,7 +467,7 @@ rmg::Area Object::Instance::getBorderAbove() const
 	int3 visitablePos = getVisitablePosition();
 	auto areaVisitable = rmg::Area({visitablePos});
 	auto borderAbove = areaVisitable.getBorderOutside();
-	vstd::erase_if(borderAbove, [&](const int3 & tile)
+	borderAbove.erase_if([&](const int3 & tile)
 	{
 		return tile.y >= visitablePos.y ||
 		(!object().blockingAt(tile + int3(0, 1, 0)) && 
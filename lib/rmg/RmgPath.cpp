@@ -10,30 +10,41 @@
 
 #include "StdInc.h"
 #include "RmgPath.h"
-#include <boost/heap/priority_queue.hpp> //A*
 
 VCMI_LIB_NAMESPACE_BEGIN
 
 using namespace rmg;
 
-const std::function<float(const int3 &, const int3 &)> Path::DEFAULT_MOVEMENT_FUNCTION =
-[](const int3 & src, const int3 & dst)
-{	
-	return 1.f;
-};
+PathNodes & PathNodes::forCurrentThread()
+{
+	thread_local PathNodes nodes;
+	return nodes;
+}
 
-//A* priority queue
-using TDistance = std::pair<int3, float>;
-struct NodeComparer
+void PathNodes::reset(const int3 & minTile, const int3 & maxTile)
 {
-	bool operator()(const TDistance & lhs, const TDistance & rhs) const
+	origin = minTile;
+	width = maxTile.x - minTile.x + 1;
+	height = maxTile.y - minTile.y + 1;
+	size_t size = static_cast<size_t>(width) * height * (maxTile.z - minTile.z + 1);
+
+	if(++generation == 0)
 	{
-		return (rhs.second < lhs.second);
+		//counter wrapped around, old marks could be mistaken for current ones
+		std::fill(distanceGeneration.begin(), distanceGeneration.end(), 0);
+		std::fill(closedGeneration.begin(), closedGeneration.end(), 0);
+		generation = 1;
 	}
-};
-boost::heap::priority_queue<TDistance, boost::heap::compare<NodeComparer>> createPriorityQueue()
-{
-	return boost::heap::priority_queue<TDistance, boost::heap::compare<NodeComparer>>();
+
+	if(distances.size() < size)
+	{
+		distanceGeneration.resize(size, 0);
+		closedGeneration.resize(size, 0);
+		distances.resize(size);
+		parents.resize(size);
+	}
+
+	open.clear();
 }
 
 Path::Path(const Area & area): dArea(&area)
@@ -62,108 +73,6 @@ Path Path::invalid()
 	return Path({});
 }
 
-Path Path::search(const Tileset & dst, bool straight, std::function<float(const int3 &, const int3 &)> moveCostFunction) const
-{
-	//A* algorithm taken from Wiki http://en.wikipedia.org/wiki/A*_search_algorithm
-	if(!dArea)
-		return Path::invalid();
-	
-	if(dst.empty()) // Skip construction of same area
-		return Path(*dArea);
-
-	auto resultArea = *dArea + dst;
-	Path result(resultArea);
-
-	int3 src = rmg::Area(dst).nearest(dPath);
-	result.connect(src);
-	
-	Tileset closed;    // The set of nodes already evaluated.
-	auto open = createPriorityQueue(); // The set of tentative nodes to be evaluated, initially containing the start node
-	std::map<int3, int3> cameFrom;  // The map of navigated nodes.
-	std::map<int3, float> distances;
-	
-	cameFrom[src] = int3(-1, -1, -1); //first node points to finish condition
-	distances[src] = 0;
-	open.push(std::make_pair(src, 0.f));
-	// Cost from start along best known path.
-	
-	while(!open.empty())
-	{
-		auto node = open.top();
-		open.pop();
-		int3 currentNode = node.first;
-		
-		closed.insert(currentNode);
-		
-		if(dPath.contains(currentNode)) //we reached connection, stop
-		{
-			// Trace the path using the saved parent information and return path
-			int3 backTracking = currentNode;
-			while (cameFrom[backTracking].valid())
-			{
-				result.dPath.add(backTracking);
-				backTracking = cameFrom[backTracking];
-			}
-			return result;
-		}
-		else
-		{
-			auto computeTileScore = [&open, &closed, &cameFrom, &currentNode, &distances, &moveCostFunction, &result](const int3& pos) -> void
-			{
-				if(closed.count(pos))
-					return;
-				
-				if(!result.dArea->contains(pos))
-					return;
-				
-				float movementCost = moveCostFunction(currentNode, pos) + currentNode.dist2d(pos);
-				
-				float distance = distances[currentNode] + movementCost; //we prefer to use already free paths
-				int bestDistanceSoFar = std::numeric_limits<int>::max();
-				auto it = distances.find(pos);
-				if(it != distances.end())
-					bestDistanceSoFar = static_cast<int>(it->second);
-				
-				if(distance < bestDistanceSoFar)
-				{
-					cameFrom[pos] = currentNode;
-					open.push(std::make_pair(pos, distance));
-					distances[pos] = distance;
-				}
-			};
-			
-			auto dirs = int3::getDirs();
-			std::vector<int3> neighbors(dirs.begin(), dirs.end());
-			if(straight)
-				neighbors.assign(rmg::dirs4.begin(), rmg::dirs4.end());
-			for(auto & i : neighbors)
-			{
-				computeTileScore(currentNode + i);
-			}
-		}
-		
-	}
-	
-	result.dPath.clear();
-	return result;
-}
-
-Path Path::search(const int3 & dst, bool straight, std::function<float(const int3 &, const int3 &)> moveCostFunction) const
-{
-	return search(Tileset{dst}, straight, std::move(moveCostFunction));
-}
-
-Path Path::search(const Area & dst, bool straight, std::function<float(const int3 &, const int3 &)> moveCostFunction) const
-{
-	return search(dst.getTiles(), straight, std::move(moveCostFunction));
-}
-
-Path Path::search(const Path & dst, bool straight, std::function<float(const int3 &, const int3 &)> moveCostFunction) const
-{
-	assert(dst.dArea == dArea);
-	return search(dst.dPath, straight, std::move(moveCostFunction));
-}
-
 void Path::connect(const int3 & path)
 {
 	dPath.add(path);
@@ -14,40 +14,223 @@
 #include "../int3.h"
 #include "RmgArea.h"
 
+#include <boost/heap/priority_queue.hpp> //A*
+
 VCMI_LIB_NAMESPACE_BEGIN
 
 namespace rmg
 {
-class Path
+/// Dense distances and parents of path search nodes over bounding box of searched area.
+/// Buffers are kept per thread and reused, generation counter marks which entries belong to current search
+class DLL_LINKAGE PathNodes
+{
+public:
+	using TDistance = std::pair<int3, float>;
+	struct NodeComparer
+	{
+		bool operator()(const TDistance & lhs, const TDistance & rhs) const
+		{
+			return (rhs.second < lhs.second);
+		}
+	};
+	using TQueue = boost::heap::priority_queue<TDistance, boost::heap::compare<NodeComparer>>;
+
+	static PathNodes & forCurrentThread();
+
+	/// Starts new search over given bounding box, previous nodes and queue are discarded
+	void reset(const int3 & minTile, const int3 & maxTile);
+
+	TQueue & queue()
+	{
+		return open;
+	}
+
+	bool isClosed(const int3 & tile) const
+	{
+		return closedGeneration[index(tile)] == generation;
+	}
+
+	void close(const int3 & tile)
+	{
+		closedGeneration[index(tile)] = generation;
+	}
+
+	bool hasDistance(const int3 & tile) const
+	{
+		return distanceGeneration[index(tile)] == generation;
+	}
+
+	float getDistance(const int3 & tile) const
+	{
+		return distances[index(tile)];
+	}
+
+	const int3 & getParent(const int3 & tile) const
+	{
+		return parents[index(tile)];
+	}
+
+	void update(const int3 & tile, float distance, const int3 & parent)
+	{
+		size_t i = index(tile);
+		distanceGeneration[i] = generation;
+		distances[i] = distance;
+		parents[i] = parent;
+	}
+
+private:
+	size_t index(const int3 & tile) const
+	{
+		return (static_cast<size_t>(tile.z - origin.z) * height + (tile.y - origin.y)) * width + (tile.x - origin.x);
+	}
+
+	int3 origin;
+	int width = 0;
+	int height = 0;
+	uint32_t generation = 0;
+	std::vector<uint32_t> distanceGeneration;
+	std::vector<uint32_t> closedGeneration;
+	std::vector<float> distances;
+	std::vector<int3> parents;
+	TQueue open;
+};
+
+class DLL_LINKAGE Path
 {
 public:
-	const static std::function<float(const int3 &, const int3 &)> DEFAULT_MOVEMENT_FUNCTION;
-	
+	/// Cost of a step added to its length, by default all tiles are equal
+	struct DefaultMovementCost
+	{
+		float operator()(const int3 &, const int3 &) const
+		{
+			return 1.f;
+		}
+	};
+
 	Path(const Area & area);
 	Path(const Area & area, const int3 & src);
 	Path(const Path & path) = default;
 	Path & operator= (const Path & path);
 	bool valid() const;
-	
-	Path search(const Tileset & dst, bool straight, std::function<float(const int3 &, const int3 &)> moveCostFunction = DEFAULT_MOVEMENT_FUNCTION) const;
-	Path search(const int3 & dst, bool straight, std::function<float(const int3 &, const int3 &)> moveCostFunction = DEFAULT_MOVEMENT_FUNCTION) const;
-	Path search(const Area & dst, bool straight, std::function<float(const int3 &, const int3 &)> moveCostFunction = DEFAULT_MOVEMENT_FUNCTION) const;
-	Path search(const Path & dst, bool straight, std::function<float(const int3 &, const int3 &)> moveCostFunction = DEFAULT_MOVEMENT_FUNCTION) const;
-	
+
+	template<typename MovementCost = DefaultMovementCost>
+	Path search(const Area & dst, bool straight, MovementCost moveCostFunction = {}) const;
+	template<typename MovementCost = DefaultMovementCost>
+	Path search(const Tileset & dst, bool straight, MovementCost moveCostFunction = {}) const
+	{
+		return search(Area(dst), straight, moveCostFunction);
+	}
+	template<typename MovementCost = DefaultMovementCost>
+	Path search(const int3 & dst, bool straight, MovementCost moveCostFunction = {}) const
+	{
+		return search(Area(Tileset{dst}), straight, moveCostFunction);
+	}
+	template<typename MovementCost = DefaultMovementCost>
+	Path search(const Path & dst, bool straight, MovementCost moveCostFunction = {}) const
+	{
+		assert(dst.dArea == dArea);
+		return search(dst.dPath, straight, moveCostFunction);
+	}
+
 	void connect(const Path & path);
 	void connect(const int3 & path); //TODO: force connection?
 	void connect(const Area & path); //TODO: force connection?
 	void connect(const Tileset & path); //TODO: force connection?
-	
+
 	const Area & getPathArea() const;
-	
+
 	static Path invalid();
-	
+
 private:
-	
+
 	const Area * dArea = nullptr;
 	Area dPath;
 };
+
+template<typename MovementCost>
+Path Path::search(const Area & dst, bool straight, MovementCost moveCostFunction) const
+{
+	//A* algorithm taken from Wiki http://en.wikipedia.org/wiki/A*_search_algorithm
+	if(!dArea)
+		return Path::invalid();
+
+	if(dst.empty()) // Skip construction of same area
+		return Path(*dArea);
+
+	auto resultArea = *dArea + dst;
+	Path result(resultArea);
+
+	int3 src = dst.nearest(dPath);
+	result.connect(src);
+
+	int3 minTile;
+	int3 maxTile;
+	resultArea.getBoundingBox(minTile, maxTile);
+
+	auto & nodes = PathNodes::forCurrentThread();
+	nodes.reset(minTile, maxTile);
+	auto & open = nodes.queue(); // The set of tentative nodes to be evaluated, initially containing the start node
+
+	nodes.update(src, 0, int3(-1, -1, -1)); //first node points to finish condition
+	open.push(std::make_pair(src, 0.f));
+
+	while(!open.empty())
+	{
+		int3 currentNode = open.top().first;
+		open.pop();
+
+		nodes.close(currentNode);
+
+		if(dPath.contains(currentNode)) //we reached connection, stop
+		{
+			// Trace the path using the saved parent information and return path
+			int3 backTracking = currentNode;
+			while(nodes.getParent(backTracking).valid())
+			{
+				result.dPath.add(backTracking);
+				backTracking = nodes.getParent(backTracking);
+			}
+			return result;
+		}
+
+		// Cost from start along best known path.
+		float currentDistance = nodes.getDistance(currentNode);
+
+		auto computeTileScore = [&](const int3 & pos)
+		{
+			if(!resultArea.contains(pos) || nodes.isClosed(pos))
+				return;
+
+			float movementCost = static_cast<float>(moveCostFunction(currentNode, pos)) + currentNode.dist2d(pos);
+
+			float distance = currentDistance + movementCost; //we prefer to use already free paths
+			int bestDistanceSoFar = std::numeric_limits<int>::max();
+			if(nodes.hasDistance(pos))
+				bestDistanceSoFar = static_cast<int>(nodes.getDistance(pos));
+
+			if(distance < bestDistanceSoFar)
+			{
+				nodes.update(pos, distance, currentNode);
+				open.push(std::make_pair(pos, distance));
+			}
+		};
+
+		if(straight)
+		{
+			for(const auto & dir : rmg::dirs4)
+				computeTileScore(currentNode + dir);
+		}
+		else
+		{
+			for(const auto & dir : int3::getDirs())
+				computeTileScore(currentNode + dir);
+		}
+	}
+
+	result.dPath.clear();
+	return result;
+}
+
 }
 
 VCMI_LIB_NAMESPACE_END
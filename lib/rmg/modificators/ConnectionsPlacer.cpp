@@ -121,6 +121,11 @@ void ConnectionsPlacer::init()
 	}
 }
 
+Modificator::EFootprint ConnectionsPlacer::getFootprint() const
+{
+	return EFootprint::SHARED_POOLS;
+}
+
 void ConnectionsPlacer::addConnection(const rmg::ZoneConnection& connection)
 {
 	dConnections.push_back(connection);
@@ -464,7 +469,7 @@ void ConnectionsPlacer::placeMonolithConnection(const rmg::ZoneConnection & conn
 void ConnectionsPlacer::collectNeighbourZones()
 {
 	auto border = zone.area()->getBorderOutside();
-	for(const auto & i : border)
+	for(const auto & i : border.getTilesVector())
 	{
 		if(!map.isOnMap(i))
 			continue;
@@ -21,6 +21,7 @@ public:
 	
 	void process() override;
 	void init() override;
+	EFootprint getFootprint() const override;
 	
 	void addConnection(const rmg::ZoneConnection& connection);
 	void placeMonolithConnection(const rmg::ZoneConnection& connection);
@@ -13,7 +13,6 @@
 #include "../Functions.h"
 #include "../CMapGenerator.h"
 #include "../RmgMap.h"
-#include "../../CStopWatch.h"
 #include "../../mapping/CMap.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
@@ -33,6 +32,11 @@ const std::string & Modificator::getName() const
 	return name;
 }
 
+const Zone & Modificator::getZone() const
+{
+	return zone;
+}
+
 bool Modificator::isReady()
 {
 	Lock lock(mx, boost::try_to_lock);
@@ -81,7 +85,8 @@ void Modificator::run()
 	if(!finished)
 	{
 		logGlobal->trace("Modificator zone %d - %s - started", zone.getId(), getName());
-		CStopWatch processTime;
+		auto startTime = std::chrono::steady_clock::now();
+		mapProxy->beginCommit(commitOrder);
 		try
 		{
 			process();
@@ -90,11 +95,13 @@ void Modificator::run()
 		{
 			logGlobal->error("Modificator %s, exception: %s", getName(), e.what());
 		}
+		mapProxy->endCommit();
 #ifdef RMG_DUMP
 		dump();
 #endif
 		finished = true;
-		logGlobal->trace("Modificator zone %d - %s - done (%d ms)", zone.getId(), getName(), processTime.getDiff());
+		processTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+		logGlobal->trace("Modificator zone %d - %s - done (%d ms)", zone.getId(), getName(), processTime);
 	}
 }
 
@@ -117,6 +124,52 @@ void Modificator::postfunction(Modificator * modificator)
 	}
 }
 
+const std::list<Modificator *> & Modificator::getPreceeders() const
+{
+	return preceeders;
+}
+
+void Modificator::setCommitOrder(size_t order)
+{
+	commitOrder = order;
+}
+
+void Modificator::prepareScheduling()
+{
+	int unfinished = 0;
+
+	for(auto * preceeder : preceeders)
+	{
+		if(!preceeder->isFinished())
+		{
+			preceeder->dependents.push_back(this);
+			unfinished++;
+		}
+	}
+
+	unfinishedPreceeders = unfinished;
+}
+
+bool Modificator::releasePreceeder()
+{
+	return --unfinishedPreceeders == 0;
+}
+
+bool Modificator::hasUnfinishedPreceeders() const
+{
+	return unfinishedPreceeders > 0;
+}
+
+const std::vector<Modificator *> & Modificator::getDependents() const
+{
+	return dependents;
+}
+
+int64_t Modificator::getProcessTime() const
+{
+	return processTime;
+}
+
 void Modificator::dump()
 {
 	// TODO: Refactor to lock zone area only once
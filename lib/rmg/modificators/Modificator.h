@@ -37,15 +37,26 @@ VCMI_LIB_NAMESPACE_BEGIN
 class Modificator
 {
 public:
+	/// Part of generator state a modificator may modify. Jobs whose footprints overlap are never run concurrently
+	/// and always run in the same relative order, so generated map doesn't depend on number of threads
+	enum class EFootprint
+	{
+		NEIGHBOURHOOD, //own zone and zones adjacent to it
+		SHARED_POOLS, //as above, and generator-wide pools (monolith ids, prison heroes, quest artifacts)
+		WHOLE_MAP //any zone
+	};
+
 	Modificator() = delete;
 	Modificator(Zone & zone, RmgMap & map, CMapGenerator & generator);
 	
 	virtual void init() {/*override to add dependencies*/}
 	virtual char dump(const int3 &);
+	virtual EFootprint getFootprint() const { return EFootprint::NEIGHBOURHOOD; }
 	virtual ~Modificator() = default;
 
 	void setName(const std::string & n);
 	const std::string & getName() const;
+	const Zone & getZone() const;
 
 	bool isReady();
 	bool isFinished();
@@ -53,6 +64,20 @@ public:
 	void run();
 	void dependency(Modificator * modificator);
 	void postfunction(Modificator * modificator);
+	const std::list<Modificator *> & getPreceeders() const;
+
+	/// Position of this modificator in the reference sequential order, map objects are committed in this order
+	void setCommitOrder(size_t order);
+
+	/// Registers this modificator as dependent of all its unfinished preceeders, must be called once before scheduling
+	void prepareScheduling();
+	/// Notifies that one of preceeders is finished, returns true if this modificator can be run now
+	bool releasePreceeder();
+	bool hasUnfinishedPreceeders() const;
+	const std::vector<Modificator *> & getDependents() const;
+
+	/// Wall time of process() in milliseconds
+	int64_t getProcessTime() const;
 
 protected:
 	RmgMap & map;
@@ -73,6 +98,11 @@ private:
 
 	std::list<Modificator*> preceeders; //must be ordered container
 
+	std::vector<Modificator *> dependents;
+	std::atomic<int> unfinishedPreceeders{0};
+	int64_t processTime = 0;
+	size_t commitOrder = 0;
+
 	mutable boost::shared_mutex mx; //Used only for task scheduling
 
 	void dump();
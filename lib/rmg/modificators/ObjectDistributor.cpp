@@ -43,6 +43,11 @@ void ObjectDistributor::init()
 	POSTFUNCTION(TreasurePlacer);
 }
 
+Modificator::EFootprint ObjectDistributor::getFootprint() const
+{
+	return EFootprint::WHOLE_MAP;
+}
+
 void ObjectDistributor::distributeLimitedObjects()
 {
 	auto zones = map.getZones();
@@ -29,6 +29,7 @@ public:
 
 	void process() override;
 	void init() override;
+	EFootprint getFootprint() const override;
 };
 
 VCMI_LIB_NAMESPACE_END
\ No newline at end of file
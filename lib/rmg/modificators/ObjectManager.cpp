@@ -74,13 +74,13 @@ void ObjectManager::init()
 
 void ObjectManager::createDistancesPriorityQueue()
 {
-	const auto tiles = zone.areaPossible()->getTilesVector();
+	tilesByDistanceArea = *zone.areaPossible();
 
 	RecursiveLock lock(externalAccessMutex);
 	tilesByDistance.clear();
-	for(const auto & tile : tiles)
+	for(const auto & tile : tilesByDistanceArea.getTilesVector())
 	{
-		tilesByDistance.push(std::make_pair(tile, map.getNearestObjectDistance(tile)));
+		tilesByDistance.emplace(tile, map.getNearestObjectDistance(tile));
 	}
 }
 
@@ -104,7 +104,21 @@ void ObjectManager::addNearbyObject(const RequiredObjectInfo & info)
 
 void ObjectManager::updateDistances(const rmg::Object & obj)
 {
-	updateDistances([obj](const int3& tile) -> ui32
+	const auto & objTiles = obj.getArea().getTilesVector();
+	if(objTiles.empty())
+		return;
+
+	int3 minTile = objTiles.front();
+	int3 maxTile = objTiles.front();
+	for(const auto & tile : objTiles)
+	{
+		vstd::amin(minTile.x, tile.x);
+		vstd::amin(minTile.y, tile.y);
+		vstd::amax(maxTile.x, tile.x);
+		vstd::amax(maxTile.y, tile.y);
+	}
+
+	updateDistances(minTile, maxTile, [&obj](const int3& tile) -> ui32
 	{
 		return obj.getArea().distanceSqr(tile); //optimization, only relative distance is interesting
 	});
@@ -112,13 +126,35 @@ void ObjectManager::updateDistances(const rmg::Object & obj)
 
 void ObjectManager::updateDistances(const int3 & pos)
 {
-	updateDistances([pos](const int3& tile) -> ui32
+	updateDistances(pos, pos, [pos](const int3& tile) -> ui32
 	{
 		return pos.dist2dSQ(tile); //optimization, only relative distance is interesting
 	});
 }
 
-void ObjectManager::updateDistances(std::function<ui32(const int3 & tile)> distanceFunction)
+void ObjectManager::syncDistancesArea()
+{
+	//Drop tiles which are no longer possible and add new ones, instead of rebuilding whole queue
+	const auto & possible = *zone.areaPossible();
+	for(const auto & tile : (tilesByDistanceArea - possible).getTilesVector())
+	{
+		tilesByDistance.erase(std::make_pair(tile, map.getNearestObjectDistance(tile)));
+	}
+	for(const auto & tile : (possible - tilesByDistanceArea).getTilesVector())
+	{
+		tilesByDistance.emplace(tile, map.getNearestObjectDistance(tile));
+	}
+	tilesByDistanceArea = possible;
+}
+
+void ObjectManager::setTileDistance(const int3 & tile, float distance)
+{
+	tilesByDistance.erase(std::make_pair(tile, map.getNearestObjectDistance(tile)));
+	map.setNearestObjectDistance(tile, distance);
+	tilesByDistance.emplace(tile, map.getNearestObjectDistance(tile));
+}
+
+void ObjectManager::updateDistances(const int3 & minTile, const int3 & maxTile, const std::function<ui32(const int3 & tile)> & distanceFunction)
 {
 	// Workaround to avoid deadlock when accessed from other zone
 	RecursiveLock lock(zone.areaMutex, boost::try_to_lock);
@@ -128,15 +164,42 @@ void ObjectManager::updateDistances(std::function<ui32(const int3 & tile)> dista
 		return;
 	}
 
-	const auto tiles = zone.areaPossible()->getTilesVector();
-	//RecursiveLock lock(externalAccessMutex);
-	tilesByDistance.clear();
+	syncDistancesArea();
+	if(tilesByDistance.empty())
+		return;
+
+	//Distance of tiles further than current maximum can't decrease, so only nearby tiles are visited
+	const float maxDistance = tilesByDistance.begin()->second;
+	const int radius = static_cast<int>(std::sqrt(static_cast<double>(maxDistance))) + 1;
 
-	for (const auto & tile : tiles) //don't need to mark distance for not possible tiles
+	int3 areaMin;
+	int3 areaMax;
+	tilesByDistanceArea.getBoundingBox(areaMin, areaMax);
+	const int3 from(std::max(minTile.x - radius, areaMin.x), std::max(minTile.y - radius, areaMin.y), areaMin.z);
+	const int3 to(std::min(maxTile.x + radius, areaMax.x), std::min(maxTile.y + radius, areaMax.y), areaMax.z);
+
+	int3 tile;
+	for(tile.z = from.z; tile.z <= to.z; tile.z++)
 	{
-		ui32 d = distanceFunction(tile);
-		map.setNearestObjectDistance(tile, std::min(static_cast<float>(d), map.getNearestObjectDistance(tile)));
-		tilesByDistance.push(std::make_pair(tile, map.getNearestObjectDistance(tile)));
+		for(tile.y = from.y; tile.y <= to.y; tile.y++)
+		{
+			const si64 dy = std::max({minTile.y - tile.y, tile.y - maxTile.y, 0});
+			for(tile.x = from.x; tile.x <= to.x; tile.x++)
+			{
+				if(!tilesByDistanceArea.contains(tile)) //don't need to mark distance for not possible tiles
+					continue;
+
+				//Squared distance to bounding box is a lower bound of distance to the object
+				const si64 dx = std::max({minTile.x - tile.x, tile.x - maxTile.x, 0});
+				const float current = map.getNearestObjectDistance(tile);
+				if(static_cast<float>(dx * dx + dy * dy) >= current)
+					continue;
+
+				const auto d = static_cast<float>(distanceFunction(tile));
+				if(d < current)
+					setTileDistance(tile, d);
+			}
+		}
 	}
 }
 
@@ -184,12 +247,8 @@ int3 ObjectManager::findPlaceForObject(const rmg::Area & searchArea, rmg::Object
 	{
 		// Do not add or remove tiles while we iterate on them
 		//RecursiveLock lock(externalAccessMutex);
-		auto open = tilesByDistance;
-
-		while(!open.empty())
+		for(const auto & node : tilesByDistance)
 		{
-			auto node = open.top();
-			open.pop();
 			int3 tile = node.first;
 			
 			if(!searchArea.contains(tile))
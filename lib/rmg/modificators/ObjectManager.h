@@ -12,7 +12,6 @@
 
 #include "../Zone.h"
 #include "../RmgObject.h"
-#include <boost/heap/priority_queue.hpp> //A*
 
 VCMI_LIB_NAMESPACE_BEGIN
 
@@ -21,11 +20,14 @@ class ObjectTemplate;
 class CGCreature;
 
 using TDistance = std::pair<int3, float>;
+/// Orders most distant tiles first, equally distant tiles by position to keep placement deterministic
 struct DistanceMaximizeFunctor
 {
 	bool operator()(const TDistance & lhs, const TDistance & rhs) const
 	{
-		return (rhs.second > lhs.second);
+		if(lhs.second != rhs.second)
+			return lhs.second > rhs.second;
+		return lhs.first < rhs.first;
 	}
 };
 
@@ -77,7 +79,6 @@ public:
 
 	void updateDistances(const rmg::Object & obj);
 	void updateDistances(const int3& pos);
-	void updateDistances(std::function<ui32(const int3 & tile)> distanceFunction);
 	void createDistancesPriorityQueue();
 
 	const rmg::Area & getVisitableArea() const;
@@ -93,8 +94,16 @@ protected:
 	std::vector<CGObjectInstance*> objects;
 	rmg::Area objectsVisitableArea;
 	
-	boost::heap::priority_queue<TDistance, boost::heap::compare<DistanceMaximizeFunctor>> tilesByDistance;
-	
+	/// Possible tiles of zone ordered by distance to nearest object, updated incrementally as objects are placed
+	std::set<TDistance, DistanceMaximizeFunctor> tilesByDistance;
+	rmg::Area tilesByDistanceArea;
+
+private:
+	/// Lowers distances of possible tiles which may be closer to new object than to any previous one.
+	/// Only tiles nearer to bounding box [minTile, maxTile] than current maximum distance are visited
+	void updateDistances(const int3 & minTile, const int3 & maxTile, const std::function<ui32(const int3 & tile)> & distanceFunction);
+	void syncDistancesArea();
+	void setTileDistance(const int3 & tile, float distance);
 };
 
 VCMI_LIB_NAMESPACE_END
@@ -83,7 +83,7 @@ void ObstaclePlacer::process()
 				rmg::Area t;
 				t.add(tile);
 
-				for (const auto& n : t.getBorderOutside())
+				for (const auto& n : t.getBorderOutside().getTilesVector())
 				{
 					//Area outside the map is also impassable
 					if (!map.isOnMap(n) || map.shouldBeBlocked(n))
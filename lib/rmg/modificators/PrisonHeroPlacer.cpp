@@ -34,6 +34,11 @@ void PrisonHeroPlacer::init()
 	reservedHeroes = 16 * generator.getMapGenOptions().getHumanOrCpuPlayerCount();
 }
 
+Modificator::EFootprint PrisonHeroPlacer::getFootprint() const
+{
+	return EFootprint::SHARED_POOLS;
+}
+
 void PrisonHeroPlacer::getAllowedHeroes()
 {
 	// TODO: Give each zone unique HeroPlacer with private hero list?
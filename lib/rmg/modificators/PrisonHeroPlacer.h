@@ -22,6 +22,7 @@ public:
 
 	void process() override;
 	void init() override;
+	EFootprint getFootprint() const override;
 
 	int getPrisonsRemaining() const;
 	[[nodiscard]] HeroTypeID drawRandomHero();
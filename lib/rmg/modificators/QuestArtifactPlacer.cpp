@@ -34,6 +34,11 @@ void QuestArtifactPlacer::init()
 	DEPENDENCY_ALL(TreasurePlacer);
 }
 
+Modificator::EFootprint QuestArtifactPlacer::getFootprint() const
+{
+	return EFootprint::WHOLE_MAP;
+}
+
 void QuestArtifactPlacer::addQuestArtZone(std::shared_ptr<Zone> otherZone)
 {
 	RecursiveLock lock(externalAccessMutex);
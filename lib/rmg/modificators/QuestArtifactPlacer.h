@@ -22,6 +22,7 @@ public:
 
 	void process() override;
 	void init() override;
+	EFootprint getFootprint() const override;
 
 	void addQuestArtZone(std::shared_ptr<Zone> otherZone);
 	void findZonesForQuestArts();
@@ -176,7 +176,7 @@ void RiverPlacer::preprocess()
 
 	rmg::Area borderArea(zone.area()->getBorder());
 	TRmgTemplateZoneId connectedToWaterZoneId = -1;
-	for(const auto & t : zone.area()->getBorderOutside())
+	for(const auto & t : zone.area()->getBorderOutside().getTilesVector())
 	{
 		if(!map.isOnMap(t))
 		{
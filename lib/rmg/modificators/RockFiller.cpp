@@ -70,6 +70,11 @@ void RockFiller::init()
 	DEPENDENCY_ALL(RockPlacer);
 }
 
+Modificator::EFootprint RockFiller::getFootprint() const
+{
+	return EFootprint::WHOLE_MAP;
+}
+
 char RockFiller::dump(const int3 & t)
 {
 	if(!map.getTile(t).terType->isPassable())
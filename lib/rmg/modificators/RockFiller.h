@@ -20,6 +20,7 @@ public:
 	
 	void process() override;
 	void init() override;
+	EFootprint getFootprint() const override;
 	char dump(const int3 &) override;
 	
 	void processMap();
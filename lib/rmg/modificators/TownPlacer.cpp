@@ -166,7 +166,7 @@ int3 TownPlacer::placeMainTown(ObjectManager & manager, CGTownInstance & town)
 void TownPlacer::cleanupBoundaries(const rmg::Object & rmgObject)
 {
 	Zone::Lock lock(zone.areaMutex);
-	for(const auto & t : rmgObject.getArea().getBorderOutside())
+	for(const auto & t : rmgObject.getArea().getBorderOutside().getTilesVector())
 	{
 		if (t.y > rmgObject.getVisitablePosition().y) //Line below the town
 		{
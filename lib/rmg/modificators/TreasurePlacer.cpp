@@ -76,6 +76,11 @@ void TreasurePlacer::init()
 	DEPENDENCY(RoadPlacer);
 }
 
+Modificator::EFootprint TreasurePlacer::getFootprint() const
+{
+	return EFootprint::SHARED_POOLS;
+}
+
 void TreasurePlacer::addObjectToRandomPool(const ObjectInfo& oi)
 {
 	if (oi.templates.empty())
@@ -778,11 +783,7 @@ rmg::Object TreasurePlacer::constructTreasurePile(const std::vector<ObjectInfo*>
 		//Put object in accessible area next to entrable area (excluding blockvis tiles)
 		if (!entrableArea.empty())
 		{
-			auto entrableBorder = entrableArea.getBorderOutside();
-			accessibleArea.erase_if([&](const int3 & tile)
-			{
-				return !entrableBorder.count(tile);
-			});
+			accessibleArea.intersect(entrableArea.getBorderOutside());
 		}
 
 		auto & instance = rmgObject.addInstance(*object);
@@ -808,11 +809,7 @@ rmg::Object TreasurePlacer::constructTreasurePile(const std::vector<ObjectInfo*>
 					instance.setPosition(t);
 
 					auto currentAccessibleArea = rmgObject.getAccessibleArea();
-					auto currentEntrableBorder = rmgObject.getEntrableArea().getBorderOutside();
-					currentAccessibleArea.erase_if([&](const int3 & tile)
-					{
-						return !currentEntrableBorder.count(tile);
-					});
+					currentAccessibleArea.intersect(rmgObject.getEntrableArea().getBorderOutside());
 
 					size_t w = currentAccessibleArea.getTilesVector().size();
 
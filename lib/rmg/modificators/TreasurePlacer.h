@@ -29,6 +29,7 @@ public:
 	
 	void process() override;
 	void init() override;
+	EFootprint getFootprint() const override;
 	char dump(const int3 &) override;
 	
 	void createTreasures(ObjectManager & manager);
@@ -118,7 +118,7 @@ void WaterProxy::collectLakes()
 		lakes.push_back(Lake{});
 		lakes.back().area = lake;
 		lakes.back().distanceMap = lake.computeDistanceMap(lakes.back().reverseDistanceMap);
-		for(const auto & t : lake.getBorderOutside())
+		for(const auto & t : lake.getBorderOutside().getTilesVector())
 			if(map.isOnMap(t))
 				lakes.back().neighbourZones[map.getZoneID(t)].add(t);
 		for(const auto & t : lake.getTilesVector())
@@ -286,7 +286,7 @@ bool WaterProxy::placeBoat(Zone & land, const Lake & lake, bool createRoad, Rout
 		auto boardingPosition = *boardingPositions.getTilesVector().begin();
 		rmg::Area shipPositions({boardingPosition});
 		auto boutside = shipPositions.getBorderOutside();
-		shipPositions.assign(boutside);
+		shipPositions = boutside;
 		shipPositions.intersect(waterAvailable);
 		if(shipPositions.empty())
 		{
@@ -349,7 +349,7 @@ bool WaterProxy::placeShipyard(Zone & land, const Lake & lake, si32 guard, bool
 		auto boardingPosition = *boardingPositions.getTilesVector().begin();
 		rmg::Area shipPositions({boardingPosition});
 		auto boutside = shipPositions.getBorderOutside();
-		shipPositions.assign(boutside);
+		shipPositions = boutside;
 		shipPositions.intersect(waterAvailable);
 		if(shipPositions.empty())
 		{
@@ -59,7 +59,7 @@ void WaterRoutes::process()
 	}
 	
 	//prohibit to place objects on the borders
-	for(const auto & t : area->getBorder())
+	for(const auto & t : area->getBorder().getTilesVector())
 	{
 		if(areaPossible->contains(t))
 		{
@@ -11,30 +11,96 @@
 #include "MapProxy.h"
 #include "../../TerrainHandler.h"
 #include "../../VCMI_Lib.h"
+#include "../../mapObjects/CGObjectInstance.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+namespace
+{
+	struct CommitSlot
+	{
+		const MapProxy * proxy = nullptr;
+		size_t order = 0;
+	};
+
+	thread_local CommitSlot currentSlot;
+}
+
 MapProxy::MapProxy(RmgMap & map):
 	map(map)
 {
 }
 
+void MapProxy::queueOperation(CGObjectInstance * obj, bool insert)
+{
+	if(currentSlot.proxy == this)
+	{
+		pendingOperations[currentSlot.order].push_back({obj, insert});
+	}
+	else if(insert)
+	{
+		map.getEditManager()->insertObject(obj);
+	}
+	else
+	{
+		map.getEditManager()->removeObject(obj);
+	}
+}
+
 void MapProxy::insertObject(CGObjectInstance * obj)
 {
 	Lock lock(mx);
-	map.getEditManager()->insertObject(obj);
+	queueOperation(obj, true);
 }
 
 void MapProxy::insertObjects(std::set<CGObjectInstance*>& objects)
 {
+	//Set is ordered by address, which differs between runs
+	std::vector<CGObjectInstance *> sorted(objects.begin(), objects.end());
+	std::sort(sorted.begin(), sorted.end(), [](const CGObjectInstance * lhs, const CGObjectInstance * rhs)
+	{
+		const int3 lpos = lhs->anchorPos();
+		const int3 rpos = rhs->anchorPos();
+		return std::make_tuple(lpos.z, lpos.y, lpos.x, lhs->ID.getNum(), lhs->subID.getNum())
+			< std::make_tuple(rpos.z, rpos.y, rpos.x, rhs->ID.getNum(), rhs->subID.getNum());
+	});
+
 	Lock lock(mx);
-	map.getEditManager()->insertObjects(objects);
+	for(auto * obj : sorted)
+		queueOperation(obj, true);
 }
 
 void MapProxy::removeObject(CGObjectInstance * obj)
 {
 	Lock lock(mx);
-	map.getEditManager()->removeObject(obj);
+	queueOperation(obj, false);
+}
+
+void MapProxy::beginCommit(size_t order)
+{
+	currentSlot.proxy = this;
+	currentSlot.order = order;
+}
+
+void MapProxy::endCommit()
+{
+	currentSlot.proxy = nullptr;
+}
+
+void MapProxy::commitObjects()
+{
+	Lock lock(mx);
+	for(const auto & slot : pendingOperations)
+	{
+		for(const auto & operation : slot.second)
+		{
+			if(operation.insert)
+				map.getEditManager()->insertObject(operation.object);
+			else
+				map.getEditManager()->removeObject(operation.object);
+		}
+	}
+	pendingOperations.clear();
 }
 
 void MapProxy::drawTerrain(vstd::RNG & generator, std::vector<int3> & tiles, TerrainId terrain)
@@ -32,11 +32,26 @@ public:
 	void drawRivers(vstd::RNG & generator, std::vector<int3> & tiles, TerrainId terrain);
 	void drawRoads(vstd::RNG & generator, std::vector<int3> & tiles, RoadId roadType);
 
+	/// Object insertions and removals done by calling thread are queued under given order until commitObjects()
+	void beginCommit(size_t order);
+	void endCommit();
+	/// Applies queued object operations to the map, sorted by commit order and then by call order
+	void commitObjects();
+
 private:
+	struct ObjectOperation
+	{
+		CGObjectInstance * object;
+		bool insert;
+	};
+
+	void queueOperation(CGObjectInstance * obj, bool insert);
+
 	mutable boost::shared_mutex mx;
 	using Lock = boost::unique_lock<boost::shared_mutex>;
 
 	RmgMap & map;
+	std::map<size_t, std::vector<ObjectOperation>> pendingOperations;
 };
 
 VCMI_LIB_NAMESPACE_END
@@ -84,8 +84,8 @@ class BinarySerializer : public CSaverBase
 public:
 	using Version = ESerializationVersion;
 
-	std::map<std::string, uint32_t> savedStrings;
-	std::map<const Serializeable*, uint32_t> savedPointers;
+	std::unordered_map<std::string, uint32_t> savedStrings;
+	std::unordered_map<const Serializeable*, uint32_t> savedPointers;
 
 	Version version = Version::CURRENT;
 	static constexpr bool trackSerializedPointers = true;
@@ -16,7 +16,9 @@ VCMI_LIB_NAMESPACE_BEGIN
 /// Rarely used directly - usually used as part of CApplier
 class CTypeList
 {
-	std::map<std::string, uint16_t> typeInfos;
+	/// Keyed by type name rather than type_info, which may not be unique across shared libraries
+	/// Names returned by type_info are static strings, so views to them remain valid
+	std::unordered_map<std::string_view, uint16_t> typeInfos;
 
 	DLL_LINKAGE CTypeList();
 
@@ -41,10 +43,7 @@ public:
 	{
 		const std::type_info & typeInfo = typeid(T);
 
-		if (typeInfos.count(typeInfo.name()) != 0)
-			return;
-
-		typeInfos[typeInfo.name()] = index;
+		typeInfos.try_emplace(typeInfo.name(), index);
 	}
 
 	template<typename T>
@@ -55,10 +54,11 @@ public:
 
 		const std::type_info & typeInfo = getTypeInfo(typePtr);
 
-		if (typeInfos.count(typeInfo.name()) == 0)
+		auto it = typeInfos.find(typeInfo.name());
+		if (it == typeInfos.end())
 			return 0;
 
-		return typeInfos.at(typeInfo.name());
+		return it->second;
 	}
 };
 
@@ -15,10 +15,26 @@
 
 #include "../gameState/CGameState.h"
 #include "../networkPacks/NetPacksBase.h"
+#include "../network/NetworkConnection.h"
 #include "../network/NetworkInterface.h"
+#include "../PerformanceStatistics.h"
+#include "ENetworkCompression.h"
+#include "ESerializationVersion.h"
+
+#include <zlib.h>
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+/// Serialized pack always starts with flag whether pack pointer is null (0 or 1),
+/// so compressed packs can be told apart from uncompressed ones by first byte
+static constexpr std::byte compressedPackMarker{0xCF};
+static constexpr size_t compressedPackHeaderSize = 1 + sizeof(uint32_t);
+/// Small packs are not worth compressing
+static constexpr size_t compressionThreshold = 256;
+/// Batch of packs starts with its own marker, followed by sequence of packs, each prefixed with its size
+static constexpr std::byte batchPackMarker{0xBA};
+static constexpr size_t batchEntryHeaderSize = sizeof(uint32_t);
+
 class DLL_LINKAGE ConnectionPackWriter final : public IBinaryWriter
 {
 public:
@@ -32,10 +48,104 @@ class DLL_LINKAGE ConnectionPackReader final : public IBinaryReader
 public:
 	const std::vector<std::byte> * buffer;
 	size_t position;
+	size_t end;
 
 	int read(std::byte * data, unsigned size) final;
 };
 
+/// Compresses packs as parts of single deflate stream, so later packs may refer to data of previous ones
+class ConnectionCompressor : boost::noncopyable
+{
+	z_stream stream = {};
+
+public:
+	ConnectionCompressor()
+	{
+		if (deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK)
+			throw std::runtime_error("Failed to initialize deflate for network connection!");
+	}
+
+	~ConnectionCompressor()
+	{
+		deflateEnd(&stream);
+	}
+
+	void compress(const std::vector<std::byte> & input, std::vector<std::byte> & output)
+	{
+		uint32_t inputSize = input.size();
+		output.resize(compressedPackHeaderSize + deflateBound(&stream, inputSize));
+		output[0] = compressedPackMarker;
+		std::memcpy(output.data() + 1, &inputSize, sizeof(inputSize));
+
+		stream.next_in = reinterpret_cast<Bytef *>(const_cast<std::byte *>(input.data()));
+		stream.avail_in = inputSize;
+		size_t written = compressedPackHeaderSize;
+
+		// Sync flush makes all data of this pack available to receiver without resetting stream history
+		do
+		{
+			if (written == output.size())
+				output.resize(output.size() * 2);
+
+			stream.next_out = reinterpret_cast<Bytef *>(output.data() + written);
+			stream.avail_out = static_cast<uInt>(output.size() - written);
+
+			int ret = deflate(&stream, Z_SYNC_FLUSH);
+			if (ret != Z_OK && ret != Z_BUF_ERROR)
+				throw std::runtime_error("Failed to compress network pack!");
+
+			written = output.size() - stream.avail_out;
+		}
+		while (stream.avail_in != 0 || stream.avail_out == 0);
+
+		output.resize(written);
+	}
+};
+
+class ConnectionDecompressor : boost::noncopyable
+{
+	z_stream stream = {};
+
+public:
+	ConnectionDecompressor()
+	{
+		if (inflateInit(&stream) != Z_OK)
+			throw std::runtime_error("Failed to initialize inflate for network connection!");
+	}
+
+	~ConnectionDecompressor()
+	{
+		inflateEnd(&stream);
+	}
+
+	void decompress(const std::vector<std::byte> & input, std::vector<std::byte> & output)
+	{
+		if (input.size() < compressedPackHeaderSize)
+			throw std::runtime_error("Failed to decompress network pack! Header is missing!");
+
+		uint32_t outputSize;
+		std::memcpy(&outputSize, input.data() + 1, sizeof(outputSize));
+
+		// size comes from peer, uncompressed pack may not be larger than any message accepted by network layer
+		if (outputSize > NetworkConnection::messageMaxSize)
+			throw std::runtime_error("Failed to decompress network pack! Invalid pack size!");
+
+		output.resize(outputSize);
+
+		stream.next_in = reinterpret_cast<Bytef *>(const_cast<std::byte *>(input.data() + compressedPackHeaderSize));
+		stream.avail_in = static_cast<uInt>(input.size() - compressedPackHeaderSize);
+		stream.next_out = reinterpret_cast<Bytef *>(output.data());
+		stream.avail_out = outputSize;
+
+		while (stream.avail_in != 0 || stream.avail_out != 0)
+		{
+			int ret = inflate(&stream, Z_SYNC_FLUSH);
+			if (ret != Z_OK)
+				throw std::runtime_error("Failed to decompress network pack!");
+		}
+	}
+};
+
 int ConnectionPackWriter::write(const std::byte * data, unsigned size)
 {
 	buffer.insert(buffer.end(), data, data + size);
@@ -44,7 +154,7 @@ int ConnectionPackWriter::write(const std::byte * data, unsigned size)
 
 int ConnectionPackReader::read(std::byte * data, unsigned size)
 {
-	if (position + size > buffer->size())
+	if (position + size > end)
 		throw std::runtime_error("End of file reached when reading received network pack!");
 
 	std::copy_n(buffer->begin() + position, size, data);
@@ -58,6 +168,11 @@ CConnection::CConnection(std::weak_ptr<INetworkConnection> networkConnection)
 	, packWriter(std::make_unique<ConnectionPackWriter>())
 	, deserializer(std::make_unique<BinaryDeserializer>(packReader.get()))
 	, serializer(std::make_unique<BinarySerializer>(packWriter.get()))
+	, compression(ENetworkCompression::NONE)
+	, incomingCompression(ENetworkCompression::NONE)
+	, batchDepth(0)
+	, batchPacksCount(0)
+	, batchCollecting(false)
 	, connectionID(-1)
 {
 	assert(networkConnection.lock() != nullptr);
@@ -77,37 +192,171 @@ void CConnection::sendPack(const CPack & pack)
 	if (!connectionPtr)
 		throw std::runtime_error("Attempt to send packet on a closed connection!");
 
-	packWriter->buffer.clear();
+	if (batchCollecting)
+	{
+		// Reserve space for size of pack, to be filled once pack is serialized
+		size_t sizePosition = packWriter->buffer.size();
+		packWriter->buffer.resize(sizePosition + batchEntryHeaderSize);
+		(*serializer) & (&pack);
+
+		uint32_t packSize = packWriter->buffer.size() - sizePosition - batchEntryHeaderSize;
+		std::memcpy(packWriter->buffer.data() + sizePosition, &packSize, sizeof(packSize));
+
+		logNetwork->trace("Adding a pack of type %s to batch", typeid(pack).name());
+		PerformanceStatistics::getInstance().addCount("network.packsSent");
+		batchPacksCount++;
+		serializer->savedPointers.clear();
+		return;
+	}
+
+	// Serialize directly into buffer that will be queued by connection, without intermediate copy
+	packWriter->buffer = connectionPtr->acquireBuffer();
 	(*serializer) & (&pack);
 
 	logNetwork->trace("Sending a pack of type %s", typeid(pack).name());
+	PerformanceStatistics::getInstance().addCount("network.packsSent");
 
-	connectionPtr->sendPacket(packWriter->buffer);
+	sendMessage(*connectionPtr, std::move(packWriter->buffer));
 	packWriter->buffer.clear();
 	serializer->savedPointers.clear();
 }
 
-std::unique_ptr<CPack> CConnection::retrievePack(const std::vector<std::byte> & data)
+void CConnection::sendMessage(INetworkConnection & connection, std::vector<std::byte> && message)
+{
+	PerformanceStatistics::getInstance().addCount("network.messagesSent");
+	PerformanceStatistics::getInstance().addCount("network.bytesSerialized", message.size());
+
+	if (compression != ENetworkCompression::NONE && message.size() >= compressionThreshold)
+	{
+		auto compressed = connection.acquireBuffer();
+		compressor->compress(message, compressed);
+		connection.sendPacket(std::move(compressed));
+	}
+	else
+	{
+		connection.sendPacket(std::move(message));
+	}
+}
+
+void CConnection::beginBatch()
+{
+	boost::mutex::scoped_lock lock(writeMutex);
+
+	if (batchDepth++ > 0)
+		return;
+
+	if (serializer->version < ESerializationVersion::NETWORK_PACK_BATCHES)
+		return;
+
+	auto connectionPtr = networkConnection.lock();
+	if (!connectionPtr)
+		return;
+
+	packWriter->buffer = connectionPtr->acquireBuffer();
+	packWriter->buffer.push_back(batchPackMarker);
+	batchPacksCount = 0;
+	batchCollecting = true;
+}
+
+void CConnection::endBatch()
+{
+	boost::mutex::scoped_lock lock(writeMutex);
+
+	assert(batchDepth > 0);
+	if (--batchDepth > 0 || !batchCollecting)
+		return;
+
+	batchCollecting = false;
+	auto connectionPtr = networkConnection.lock();
+
+	if (connectionPtr && batchPacksCount != 0)
+	{
+		// Single pack is sent as it is, without batch overhead
+		if (batchPacksCount == 1)
+			packWriter->buffer.erase(packWriter->buffer.begin(), packWriter->buffer.begin() + 1 + batchEntryHeaderSize);
+
+		logNetwork->trace("Sending a batch of %d packs", batchPacksCount);
+		sendMessage(*connectionPtr, std::move(packWriter->buffer));
+	}
+	packWriter->buffer.clear();
+}
+
+const std::vector<std::byte> & CConnection::decompressMessage(const std::vector<std::byte> & message)
+{
+	if (message.empty() || message.front() != compressedPackMarker)
+		return message;
+
+	if (incomingCompression == ENetworkCompression::NONE)
+		throw std::runtime_error("Received compressed network pack while compression was not negotiated!");
+
+	if (!decompressor)
+		decompressor = std::make_unique<ConnectionDecompressor>();
+	decompressor->decompress(message, decompressedBuffer);
+	return decompressedBuffer;
+}
+
+std::unique_ptr<CPack> CConnection::deserializePack(const std::vector<std::byte> & data, size_t begin, size_t end)
 {
 	std::unique_ptr<CPack> result;
 
 	packReader->buffer = &data;
-	packReader->position = 0;
+	packReader->position = begin;
+	packReader->end = end;
 
 	*deserializer & result;
 
 	if (result == nullptr)
 		throw std::runtime_error("Failed to retrieve pack!");
 
-	if (packReader->position != data.size())
+	if (packReader->position != end)
 		throw std::runtime_error("Failed to retrieve pack! Not all data has been read!");
 
 	logNetwork->trace("Received CPack of type %s", typeid(result.get()).name());
+	PerformanceStatistics::getInstance().addCount("network.packsReceived");
 	deserializer->loadedPointers.clear();
 	deserializer->loadedSharedPointers.clear();
 	return result;
 }
 
+std::unique_ptr<CPack> CConnection::retrievePack(const std::vector<std::byte> & message)
+{
+	const auto & data = decompressMessage(message);
+
+	if (!data.empty() && data.front() == batchPackMarker)
+		throw std::runtime_error("Failed to retrieve pack! Received batch of packs where single pack was expected!");
+
+	return deserializePack(data, 0, data.size());
+}
+
+void CConnection::retrievePacks(const std::vector<std::byte> & message, const std::function<bool(std::unique_ptr<CPack>)> & callback)
+{
+	const auto & data = decompressMessage(message);
+
+	if (data.empty() || data.front() != batchPackMarker)
+	{
+		callback(deserializePack(data, 0, data.size()));
+		return;
+	}
+
+	// Packs of batch may refer to objects created by previous packs, so each pack must be applied before next one is loaded
+	size_t position = 1;
+	while (position != data.size())
+	{
+		uint32_t packSize;
+		if (position + batchEntryHeaderSize > data.size())
+			throw std::runtime_error("Failed to retrieve batch of packs! Pack header is missing!");
+		std::memcpy(&packSize, data.data() + position, sizeof(packSize));
+		position += batchEntryHeaderSize;
+
+		if (position + packSize > data.size())
+			throw std::runtime_error("Failed to retrieve batch of packs! Pack is truncated!");
+
+		if (!callback(deserializePack(data, position, position + packSize)))
+			return;
+		position += packSize;
+	}
+}
+
 bool CConnection::isMyConnection(const std::shared_ptr<INetworkConnection> & otherConnection) const
 {
 	return otherConnection != nullptr && networkConnection.lock() == otherConnection;
@@ -169,4 +418,32 @@ void CConnection::setSerializationVersion(ESerializationVersion version)
 	serializer->version = version;
 }
 
+ENetworkCompression CConnection::getPreferredCompression()
+{
+	auto connectionPtr = networkConnection.lock();
+
+	// Local connections are not limited by bandwidth
+	if (!connectionPtr || connectionPtr->isLoopback())
+		return ENetworkCompression::NONE;
+	return ENetworkCompression::ZLIB;
+}
+
+void CConnection::setCompression(ENetworkCompression mode)
+{
+	boost::mutex::scoped_lock lock(writeMutex);
+
+	compression = mode;
+	if (compression != ENetworkCompression::NONE && !compressor)
+		compressor = std::make_unique<ConnectionCompressor>();
+
+	acceptCompression(mode);
+}
+
+void CConnection::acceptCompression(ENetworkCompression mode)
+{
+	// once accepted, compressed stream may continue even if peer disables compression later
+	if (mode != ENetworkCompression::NONE)
+		incomingCompression = mode;
+}
+
 VCMI_LIB_NAMESPACE_END
@@ -10,6 +10,7 @@
 #pragma once
 
 enum class ESerializationVersion : int32_t;
+enum class ENetworkCompression : int8_t;
 
 VCMI_LIB_NAMESPACE_BEGIN
 
@@ -19,6 +20,8 @@ struct CPack;
 class INetworkConnection;
 class ConnectionPackReader;
 class ConnectionPackWriter;
+class ConnectionCompressor;
+class ConnectionDecompressor;
 class CGameState;
 class IGameCallback;
 
@@ -33,9 +36,26 @@ class DLL_LINKAGE CConnection : boost::noncopyable
 	std::unique_ptr<ConnectionPackWriter> packWriter;
 	std::unique_ptr<BinaryDeserializer> deserializer;
 	std::unique_ptr<BinarySerializer> serializer;
+	/// Deflate streams used for packs above size threshold, created once compression is enabled or first compressed pack is received
+	/// Compressor is kept even if compression gets disabled, since receiver expects continuation of same stream
+	ENetworkCompression compression;
+	/// Compression of incoming packs, compressed packs are rejected until it was negotiated
+	std::atomic<ENetworkCompression> incomingCompression;
+	std::unique_ptr<ConnectionCompressor> compressor;
+	std::unique_ptr<ConnectionDecompressor> decompressor;
+	std::vector<std::byte> decompressedBuffer;
+
+	/// Nesting level of active batches. While above zero, packs are collected in packWriter buffer and sent once outermost batch ends
+	int batchDepth;
+	size_t batchPacksCount;
+	bool batchCollecting;
 
 	boost::mutex writeMutex;
 
+	void sendMessage(INetworkConnection & connection, std::vector<std::byte> && message);
+	const std::vector<std::byte> & decompressMessage(const std::vector<std::byte> & message);
+	std::unique_ptr<CPack> deserializePack(const std::vector<std::byte> & data, size_t begin, size_t end);
+
 	void disableStackSendingByID();
 	void enableStackSendingByID();
 	void disableSmartVectorMemberSerialization();
@@ -52,12 +72,29 @@ public:
 	~CConnection();
 
 	void sendPack(const CPack & pack);
-	std::unique_ptr<CPack> retrievePack(const std::vector<std::byte> & data);
+	std::unique_ptr<CPack> retrievePack(const std::vector<std::byte> & message);
+	/// Retrieves all packs from message that may contain a batch of packs
+	/// Packs are deserialized one by one, after callback has processed previous pack of the batch
+	/// Remaining packs are skipped if callback returns false
+	void retrievePacks(const std::vector<std::byte> & message, const std::function<bool(std::unique_ptr<CPack>)> & callback);
+
+	/// Starts collecting sent packs into a single network message. Batches can be nested
+	/// Has no effect if remote side does not support batches
+	void beginBatch();
+	/// Ends batch and sends all collected packs if this was the outermost batch
+	void endBatch();
 
 	void enterLobbyConnectionMode();
 	void setCallback(IGameCallback * cb);
 	void enterGameplayConnectionMode(CGameState * gs);
 	void setSerializationVersion(ESerializationVersion version);
+
+	/// Returns best compression supported for this connection, no compression for local connections
+	ENetworkCompression getPreferredCompression();
+	/// Enables compression of outgoing packs and accepts compressed incoming packs
+	void setCompression(ENetworkCompression mode);
+	/// Accepts compressed incoming packs, used when requesting compression since peer may enable it before we receive its answer
+	void acceptCompression(ENetworkCompression mode);
 };
 
 VCMI_LIB_NAMESPACE_END
@@ -0,0 +1,18 @@
+/*
+ * ENetworkCompression.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+/// Compression of packs sent over game connection, negotiated when client connects to server
+/// Values are ordered by preference, both sides use lowest of modes supported by them
+enum class ENetworkCompression : int8_t
+{
+	NONE,
+	ZLIB // deflate stream that is shared by all packs sent over connection
+};
@@ -65,6 +65,8 @@ enum class ESerializationVersion : int32_t
 	LOCAL_PLAYER_STATE_DATA, // 866 - player state contains arbitrary client-side data
 	REMOVE_TOWN_PTR, // 867 - removed pointer to CTown from CGTownInstance
 	REMOVE_OBJECT_TYPENAME, // 868 - remove typename from CGObjectInstance
+	NETWORK_COMPRESSION, // 869 - compression of game connection is negotiated on connect
+	NETWORK_PACK_BATCHES, // 870 - server may send multiple packs in a single network message
 
-	CURRENT = REMOVE_OBJECT_TYPENAME
+	CURRENT = NETWORK_PACK_BATCHES
 };
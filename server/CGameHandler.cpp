@@ -36,6 +36,7 @@
 #include "../lib/GameConstants.h"
 #include "../lib/UnlockGuard.h"
 #include "../lib/IGameSettings.h"
+#include "../lib/ScopeGuard.h"
 #include "../lib/ScriptHandler.h"
 #include "../lib/StartInfo.h"
 #include "../lib/TerrainHandler.h"
@@ -460,43 +461,46 @@ void CGameHandler::handleClientDisconnection(std::shared_ptr<CConnection> c)
 
 void CGameHandler::handleReceivedPack(CPackForServer & pack)
 {
-	//prepare struct informing that action was applied
-	auto sendPackageResponse = [&](bool successfullyApplied)
+	sendBatched([&]()
 	{
-		PackageApplied applied;
-		applied.player = pack.player;
-		applied.result = successfullyApplied;
-		applied.packType = CTypeList::getInstance().getTypeID(&pack);
-		applied.requestID = pack.requestID;
-		pack.c->sendPack(applied);
-	};
+		//prepare struct informing that action was applied
+		auto sendPackageResponse = [&](bool successfullyApplied)
+		{
+			PackageApplied applied;
+			applied.player = pack.player;
+			applied.result = successfullyApplied;
+			applied.packType = CTypeList::getInstance().getTypeID(&pack);
+			applied.requestID = pack.requestID;
+			pack.c->sendPack(applied);
+		};
 
-	if(isBlockedByQueries(&pack, pack.player))
-	{
-		sendPackageResponse(false);
-	}
-	else
-	{
-		bool result;
-		try
+		if(isBlockedByQueries(&pack, pack.player))
 		{
-			ApplyGhNetPackVisitor applier(*this);
-			pack.visit(applier);
-			result = applier.getResult();
+			sendPackageResponse(false);
 		}
-		catch(ExceptionNotAllowedAction &)
+		else
 		{
-			result = false;
-		}
+			bool result;
+			try
+			{
+				ApplyGhNetPackVisitor applier(*this);
+				pack.visit(applier);
+				result = applier.getResult();
+			}
+			catch(ExceptionNotAllowedAction &)
+			{
+				result = false;
+			}
 
-		if(result)
-			logGlobal->trace("Message %s successfully applied!", typeid(pack).name());
-		else
-			complain((boost::format("Got false in applying %s... that request must have been fishy!")
-				% typeid(pack).name()).str());
+			if(result)
+				logGlobal->trace("Message %s successfully applied!", typeid(pack).name());
+			else
+				complain((boost::format("Got false in applying %s... that request must have been fishy!")
+					% typeid(pack).name()).str());
 
-		sendPackageResponse(true);
-	}
+			sendPackageResponse(true);
+		}
+	});
 }
 
 CGameHandler::CGameHandler(CVCMIServer * lobby)
@@ -535,7 +539,9 @@ void CGameHandler::reinitScripting()
 
 void CGameHandler::init(StartInfo *si, Load::ProgressAccumulator & progressTracking)
 {
-	int requestedSeed = settings["server"]["seed"].Integer();
+	int requestedSeed = settings["session"]["seed"].Integer();
+	if (requestedSeed == 0)
+		requestedSeed = settings["server"]["seed"].Integer();
 	if (requestedSeed != 0)
 		randomNumberGenerator->setSeed(requestedSeed);
 	logGlobal->info("Using random seed: %d", randomNumberGenerator->nextInt());
@@ -738,7 +744,10 @@ void CGameHandler::start(bool resume)
 
 void CGameHandler::tick(int millisecondsPassed)
 {
-	turnTimerHandler->update(millisecondsPassed);
+	sendBatched([&]()
+	{
+		turnTimerHandler->update(millisecondsPassed);
+	});
 }
 
 void CGameHandler::giveSpells(const CGTownInstance *t, const CGHeroInstance *h)
@@ -1441,6 +1450,22 @@ void CGameHandler::sendToAllClients(CPackForClient & pack)
 		c->sendPack(pack);
 }
 
+void CGameHandler::sendBatched(const std::function<void()> & action)
+{
+	// Client may disconnect while action is processed, so batches are ended only on connections that have started them
+	auto connections = lobby->activeConnections;
+	for (auto & c : connections)
+		c->beginBatch();
+
+	auto endBatches = vstd::makeScopeGuard([&connections]()
+	{
+		for (auto & c : connections)
+			c->endBatch();
+	});
+
+	action();
+}
+
 void CGameHandler::sendAndApply(CPackForClient & pack)
 {
 	sendToAllClients(pack);
@@ -261,6 +261,8 @@ public:
 	}
 
 	void sendToAllClients(CPackForClient & pack);
+	/// Packs sent to clients during action are delivered as a single network message per client once action is over
+	void sendBatched(const std::function<void()> & action);
 	void sendAndApply(CPackForClient & pack) override;
 	void sendAndApply(CGarrisonOperationPack & pack);
 	void sendAndApply(SetResources & pack);
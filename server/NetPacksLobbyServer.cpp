@@ -50,6 +50,9 @@ void ApplyOnServerNetPackVisitor::visitLobbyClientConnected(LobbyClientConnected
 	auto compatibleVersion = std::min(pack.version, ESerializationVersion::CURRENT);
 	pack.c->setSerializationVersion(compatibleVersion);
 
+	auto compression = std::min(pack.compression, pack.c->getPreferredCompression());
+	pack.c->setCompression(compression);
+
 	srv.clientConnected(pack.c, pack.names, pack.uuid, pack.mode);
 
 	// Server need to pass some data to newly connected client
@@ -57,6 +60,7 @@ void ApplyOnServerNetPackVisitor::visitLobbyClientConnected(LobbyClientConnected
 	pack.mode = srv.si->mode;
 	pack.hostClientId = srv.hostClientId;
 	pack.version = compatibleVersion;
+	pack.compression = compression;
 
 	result = true;
 }
@@ -120,3 +120,26 @@ TEST(BattleHexTest, moveEDir)
 	mainHex.moveInDirection(BattleHex::EDir::BOTTOM_LEFT);
 	EXPECT_EQ(mainHex, 20);
 }
+
+TEST(BattleHexTest, neighbouringTilesCacheMatchesDirections)
+{
+	for(si16 hex = 0; hex < GameConstants::BFIELD_SIZE; hex++)
+	{
+		std::vector<BattleHex> expected;
+
+		for(auto dir : {BattleHex::TOP_LEFT, BattleHex::TOP_RIGHT, BattleHex::RIGHT, BattleHex::BOTTOM_RIGHT, BattleHex::BOTTOM_LEFT, BattleHex::LEFT})
+			BattleHex::checkAndPush(BattleHex(hex).cloneInDirection(dir, false), expected);
+
+		size_t index = 0;
+
+		for(si16 neighbour : BattleHex::neighbouringTilesCache[hex])
+		{
+			if(index < expected.size())
+				EXPECT_EQ(neighbour, expected[index]);
+			else
+				EXPECT_EQ(neighbour, -1);
+
+			index++;
+		}
+	}
+}
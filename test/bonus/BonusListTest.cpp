@@ -0,0 +1,75 @@
+/*
+ * BonusListTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../../lib/bonuses/BonusList.h"
+
+using namespace testing;
+
+class BonusListTest : public Test
+{
+public:
+	BonusList list;
+
+	void addBonus(BonusType type, int value)
+	{
+		list.push_back(std::make_shared<Bonus>(BonusDuration::PERMANENT, type, BonusSource::OTHER, value, BonusSourceID()));
+	}
+
+	BonusListTest()
+	{
+		addBonus(BonusType::LUCK, 1);
+		addBonus(BonusType::MORALE, 2);
+		addBonus(BonusType::LUCK, 3);
+		addBonus(BonusType::STACK_HEALTH, 4);
+		addBonus(BonusType::LUCK, 5);
+	}
+};
+
+TEST_F(BonusListTest, TypeIndexGivesSameResults)
+{
+	const auto selectors = {
+		Selector::type()(BonusType::LUCK),
+		Selector::type()(BonusType::MORALE),
+		Selector::type()(BonusType::FLYING),
+		Selector::type()(BonusType::LUCK).And(Selector::sourceType()(BonusSource::OTHER)),
+		Selector::all
+	};
+
+	std::vector<BonusList> expected;
+	for(const auto & selector : selectors)
+	{
+		expected.emplace_back();
+		list.getBonuses(expected.back(), selector);
+	}
+
+	list.buildTypeIndex();
+
+	size_t index = 0;
+	for(const auto & selector : selectors)
+	{
+		BonusList result;
+		list.getBonuses(result, selector);
+
+		ASSERT_EQ(result.size(), expected[index].size());
+		for(size_t i = 0; i < result.size(); ++i)
+			EXPECT_EQ(result[i], expected[index][i]);
+		index++;
+	}
+}
+
+TEST_F(BonusListTest, TypeIndexIsDroppedOnModification)
+{
+	list.buildTypeIndex();
+	addBonus(BonusType::MORALE, 6);
+
+	EXPECT_EQ(list.valOfBonuses(Selector::type()(BonusType::MORALE)), 8);
+	EXPECT_EQ(list.valOfBonuses(Selector::type()(BonusType::LUCK)), 9);
+}
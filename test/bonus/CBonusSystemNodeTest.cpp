@@ -0,0 +1,136 @@
+/*
+ * CBonusSystemNodeTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../../lib/bonuses/CBonusSystemNode.h"
+
+using namespace testing;
+
+class CBonusSystemNodeTest : public Test
+{
+public:
+	CBonusSystemNode parent;
+	CBonusSystemNode first;
+	CBonusSystemNode second;
+
+	CBonusSystemNodeTest()
+		: parent(CBonusSystemNode::PLAYER),
+		first(CBonusSystemNode::HERO),
+		second(CBonusSystemNode::HERO)
+	{
+		first.attachTo(parent);
+		second.attachTo(parent);
+	}
+
+	static std::shared_ptr<Bonus> makeBonus(int value)
+	{
+		return std::make_shared<Bonus>(BonusDuration::PERMANENT, BonusType::LUCK, BonusSource::OTHER, value, BonusSourceID());
+	}
+};
+
+TEST_F(CBonusSystemNodeTest, ChangeInvalidatesOnlyChangedNode)
+{
+	const auto parentVersion = parent.getTreeVersion();
+	const auto secondVersion = second.getTreeVersion();
+
+	first.addNewBonus(makeBonus(1));
+
+	EXPECT_EQ(parent.getTreeVersion(), parentVersion);
+	EXPECT_EQ(second.getTreeVersion(), secondVersion);
+	EXPECT_EQ(first.valOfBonuses(BonusType::LUCK), 1);
+	EXPECT_EQ(second.valOfBonuses(BonusType::LUCK), 0);
+}
+
+TEST_F(CBonusSystemNodeTest, ParentChangeInvalidatesChildren)
+{
+	EXPECT_EQ(first.valOfBonuses(BonusType::LUCK), 0);
+	EXPECT_EQ(second.valOfBonuses(BonusType::LUCK), 0);
+
+	const auto firstVersion = first.getTreeVersion();
+	const auto secondVersion = second.getTreeVersion();
+
+	parent.addNewBonus(makeBonus(2));
+
+	EXPECT_NE(first.getTreeVersion(), firstVersion);
+	EXPECT_NE(second.getTreeVersion(), secondVersion);
+	EXPECT_EQ(first.valOfBonuses(BonusType::LUCK), 2);
+	EXPECT_EQ(second.valOfBonuses(BonusType::LUCK), 2);
+}
+
+TEST_F(CBonusSystemNodeTest, DetachInvalidatesChild)
+{
+	parent.addNewBonus(makeBonus(3));
+	EXPECT_EQ(first.valOfBonuses(BonusType::LUCK), 3);
+
+	first.detachFrom(parent);
+
+	EXPECT_EQ(first.valOfBonuses(BonusType::LUCK), 0);
+	EXPECT_EQ(second.valOfBonuses(BonusType::LUCK), 3);
+}
+
+TEST_F(CBonusSystemNodeTest, HypotheticNodeSeesParentChange)
+{
+	CBonusSystemNode hypothetic(true);
+	hypothetic.attachTo(first);
+
+	EXPECT_EQ(hypothetic.valOfBonuses(BonusType::LUCK), 0);
+
+	parent.addNewBonus(makeBonus(4));
+
+	EXPECT_EQ(hypothetic.valOfBonuses(BonusType::LUCK), 4);
+
+	hypothetic.detachFrom(first);
+}
+
+TEST_F(CBonusSystemNodeTest, GlobalChangeInvalidatesAllNodes)
+{
+	const auto firstVersion = first.getTreeVersion();
+	const auto secondVersion = second.getTreeVersion();
+
+	CBonusSystemNode::treeHasChanged();
+
+	EXPECT_NE(first.getTreeVersion(), firstVersion);
+	EXPECT_NE(second.getTreeVersion(), secondVersion);
+}
+
+TEST_F(CBonusSystemNodeTest, SelectorKeyDescribesSimpleSelectors)
+{
+	auto typeSubtype = Selector::typeSubtype(BonusType::PRIMARY_SKILL, BonusSubtypeID(PrimarySkill::ATTACK));
+	auto sameSelector = Selector::type()(BonusType::PRIMARY_SKILL).And(Selector::subtype()(BonusSubtypeID(PrimarySkill::ATTACK)));
+	auto otherSelector = Selector::typeSubtype(BonusType::PRIMARY_SKILL, BonusSubtypeID(PrimarySkill::DEFENSE));
+
+	ASSERT_TRUE(typeSubtype.getKey());
+	ASSERT_TRUE(sameSelector.getKey());
+	ASSERT_TRUE(otherSelector.getKey());
+	EXPECT_TRUE(*typeSubtype.getKey() == *sameSelector.getKey());
+	EXPECT_FALSE(*typeSubtype.getKey() == *otherSelector.getKey());
+
+	EXPECT_FALSE(typeSubtype.Not().getKey());
+	EXPECT_FALSE(typeSubtype.Or(otherSelector).getKey());
+	EXPECT_FALSE(Selector::type()(BonusType::LUCK).And(Selector::type()(BonusType::MORALE)).getKey());
+	EXPECT_TRUE(Selector::all.selectsAll());
+}
+
+TEST_F(CBonusSystemNodeTest, KeyedRequestsAreCached)
+{
+	first.addNewBonus(makeBonus(5));
+
+	auto request = first.getBonuses(Selector::type()(BonusType::LUCK));
+	auto sameRequest = first.getBonuses(Selector::type()(BonusType::LUCK), Selector::all);
+
+	EXPECT_EQ(request, sameRequest);
+	EXPECT_EQ(request->totalValue(), 5);
+
+	first.addNewBonus(makeBonus(6));
+
+	auto updatedRequest = first.getBonuses(Selector::type()(BonusType::LUCK));
+	EXPECT_NE(request, updatedRequest);
+	EXPECT_EQ(updatedRequest->totalValue(), 11);
+}
@@ -0,0 +1,225 @@
+/*
+ * CConnectionCompressionTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/network/NetworkInterface.h"
+#include "../../lib/networkPacks/PacksForLobby.h"
+#include "../../lib/serializer/Connection.h"
+#include "../../lib/serializer/ENetworkCompression.h"
+
+namespace test
+{
+using namespace ::testing;
+
+/// Connection that keeps all sent messages instead of writing them to socket
+class RecordingNetworkConnection : public INetworkConnection
+{
+public:
+	std::vector<std::vector<std::byte>> sent;
+
+	void sendPacket(const std::vector<std::byte> & message) override
+	{
+		sent.push_back(message);
+	}
+
+	void sendPacket(std::vector<std::byte> && message) override
+	{
+		sent.push_back(std::move(message));
+	}
+
+	std::vector<std::byte> acquireBuffer() override
+	{
+		return {};
+	}
+
+	bool isLoopback() const override
+	{
+		return false;
+	}
+
+	void setAsyncWritesEnabled(bool on) override {}
+	void close() override {}
+};
+
+class CConnectionCompressionTest : public Test
+{
+public:
+	std::shared_ptr<RecordingNetworkConnection> senderNetwork = std::make_shared<RecordingNetworkConnection>();
+	std::shared_ptr<RecordingNetworkConnection> receiverNetwork = std::make_shared<RecordingNetworkConnection>();
+	CConnection sender{senderNetwork};
+	CConnection receiver{receiverNetwork};
+
+	/// Sequence of chat messages similar to ones sent during multiplayer game, some of them above compression threshold
+	std::vector<LobbyChatMessage> recordGame()
+	{
+		static const std::vector<std::string> words = {"hero", "castle", "dragon", "gold", "attack", "week", "artifact", "mine", "turn", "wait"};
+		std::mt19937 gen(42);
+		std::uniform_int_distribution<size_t> word(0, words.size() - 1);
+		std::uniform_int_distribution<int> length(1, 120);
+
+		std::vector<LobbyChatMessage> result(500);
+		for(auto & pack : result)
+		{
+			std::string text;
+			for(int i = length(gen); i > 0; i--)
+				text += words[word(gen)] + " ";
+
+			pack.playerName = "Player " + std::to_string(word(gen));
+			pack.message.appendRawString(text);
+		}
+		return result;
+	}
+
+	size_t sendAndReceive(const std::vector<LobbyChatMessage> & packs)
+	{
+		size_t bytes = 0;
+		for(const auto & pack : packs)
+			sender.sendPack(pack);
+
+		for(size_t i = 0; i < packs.size(); i++)
+		{
+			bytes += senderNetwork->sent[i].size();
+			auto received = receiver.retrievePack(senderNetwork->sent[i]);
+			auto * message = dynamic_cast<LobbyChatMessage *>(received.get());
+
+			EXPECT_NE(message, nullptr);
+			if(message)
+			{
+				EXPECT_EQ(message->playerName, packs[i].playerName);
+				EXPECT_EQ(message->message.toString(), packs[i].message.toString());
+			}
+		}
+		senderNetwork->sent.clear();
+		return bytes;
+	}
+};
+
+TEST_F(CConnectionCompressionTest, packsAreUnchangedByCompression)
+{
+	EXPECT_EQ(sender.getPreferredCompression(), ENetworkCompression::ZLIB);
+
+	auto packs = recordGame();
+
+	auto start = std::chrono::steady_clock::now();
+	size_t uncompressedBytes = sendAndReceive(packs);
+	auto uncompressedTime = std::chrono::steady_clock::now() - start;
+
+	sender.setCompression(ENetworkCompression::ZLIB);
+	receiver.acceptCompression(ENetworkCompression::ZLIB);
+
+	start = std::chrono::steady_clock::now();
+	size_t compressedBytes = sendAndReceive(packs);
+	auto compressedTime = std::chrono::steady_clock::now() - start;
+
+	// Compressed stream continues even if compression is disabled and enabled again
+	sender.setCompression(ENetworkCompression::NONE);
+	sendAndReceive(packs);
+	sender.setCompression(ENetworkCompression::ZLIB);
+	sendAndReceive(packs);
+
+	EXPECT_LT(compressedBytes * 2, uncompressedBytes);
+
+	RecordProperty("uncompressedBytes", std::to_string(uncompressedBytes));
+	RecordProperty("compressedBytes", std::to_string(compressedBytes));
+	RecordProperty("uncompressedMicroseconds", std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(uncompressedTime).count()));
+	RecordProperty("compressedMicroseconds", std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(compressedTime).count()));
+}
+
+TEST_F(CConnectionCompressionTest, batchIsSentAsSingleCompressedMessage)
+{
+	auto packs = recordGame();
+	sender.setCompression(ENetworkCompression::ZLIB);
+	receiver.acceptCompression(ENetworkCompression::ZLIB);
+
+	sender.beginBatch();
+	sender.beginBatch();
+	for(const auto & pack : packs)
+		sender.sendPack(pack);
+	sender.endBatch();
+	EXPECT_TRUE(senderNetwork->sent.empty());
+	sender.endBatch();
+
+	ASSERT_EQ(senderNetwork->sent.size(), 1);
+
+	size_t receivedCount = 0;
+	receiver.retrievePacks(senderNetwork->sent[0], [&](std::unique_ptr<CPack> received)
+	{
+		auto * message = dynamic_cast<LobbyChatMessage *>(received.get());
+		EXPECT_NE(message, nullptr);
+		if(message && receivedCount < packs.size())
+		{
+			EXPECT_EQ(message->message.toString(), packs[receivedCount].message.toString());
+		}
+		receivedCount++;
+		return true;
+	});
+	EXPECT_EQ(receivedCount, packs.size());
+
+	// Batch with single pack is sent as plain pack
+	senderNetwork->sent.clear();
+	sender.beginBatch();
+	sender.sendPack(packs[0]);
+	sender.endBatch();
+	ASSERT_EQ(senderNetwork->sent.size(), 1);
+	EXPECT_NE(receiver.retrievePack(senderNetwork->sent[0]), nullptr);
+}
+
+TEST_F(CConnectionCompressionTest, compressedPacksRequireNegotiation)
+{
+	auto packs = recordGame();
+	sender.setCompression(ENetworkCompression::ZLIB);
+	sender.sendPack(packs[0]);
+	ASSERT_EQ(senderNetwork->sent.size(), 1);
+
+	EXPECT_THROW(receiver.retrievePack(senderNetwork->sent[0]), std::runtime_error);
+}
+
+TEST_F(CConnectionCompressionTest, compressedPackSizeIsLimited)
+{
+	receiver.acceptCompression(ENetworkCompression::ZLIB);
+
+	// header of compressed pack claiming 4 GB of uncompressed data
+	std::vector<std::byte> message(5, std::byte{0xff});
+	message[0] = std::byte{0xcf};
+
+	EXPECT_THROW(receiver.retrievePack(message), std::runtime_error);
+}
+
+TEST_F(CConnectionCompressionTest, clientConnectedPackOfOlderVersion)
+{
+	// connections use current version until handshake, pack of older client must still be readable
+	LobbyClientConnected oldPack;
+	oldPack.uuid = "old-client";
+	oldPack.names = {"Player"};
+	oldPack.version = ESerializationVersion::REMOVE_OBJECT_TYPENAME;
+	oldPack.compression = ENetworkCompression::ZLIB;
+
+	LobbyClientConnected newPack = oldPack;
+	newPack.version = ESerializationVersion::CURRENT;
+
+	sender.sendPack(oldPack);
+	sender.sendPack(newPack);
+	ASSERT_EQ(senderNetwork->sent.size(), 2);
+
+	auto received = receiver.retrievePack(senderNetwork->sent[0]);
+	auto * clientConnected = dynamic_cast<LobbyClientConnected *>(received.get());
+	ASSERT_NE(clientConnected, nullptr);
+	EXPECT_EQ(clientConnected->uuid, "old-client");
+	EXPECT_EQ(clientConnected->version, ESerializationVersion::REMOVE_OBJECT_TYPENAME);
+	EXPECT_EQ(clientConnected->compression, ENetworkCompression::NONE);
+
+	received = receiver.retrievePack(senderNetwork->sent[1]);
+	clientConnected = dynamic_cast<LobbyClientConnected *>(received.get());
+	ASSERT_NE(clientConnected, nullptr);
+	EXPECT_EQ(clientConnected->version, ESerializationVersion::CURRENT);
+	EXPECT_EQ(clientConnected->compression, ENetworkCompression::ZLIB);
+}
+
+}
@@ -0,0 +1,98 @@
+/*
+ * PathfinderQueueTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../../lib/pathfinder/CGPathNode.h"
+#include "../../lib/pathfinder/PathfinderQueue.h"
+
+using namespace testing;
+
+class PathfinderQueueTest : public Test
+{
+public:
+	PathfinderQueue<CGPathNode> queue;
+	std::vector<CGPathNode> nodes;
+
+	std::vector<float> popAll()
+	{
+		std::vector<float> result;
+
+		while(!queue.empty())
+		{
+			auto * node = queue.pop();
+
+			if(node)
+				result.push_back(node->getCost());
+		}
+
+		return result;
+	}
+};
+
+TEST_F(PathfinderQueueTest, PopsNodesInCostOrder)
+{
+	const std::vector<float> costs = {3.5f, 0.0f, 1.25f, 7.0f, 0.75f, 1.25f, 2.0f, 0.001f};
+
+	nodes.resize(costs.size());
+
+	for(size_t i = 0; i < costs.size(); i++)
+	{
+		nodes[i].setCost(costs[i]);
+		queue.push(&nodes[i]);
+	}
+
+	auto expected = costs;
+	std::sort(expected.begin(), expected.end());
+
+	EXPECT_EQ(popAll(), expected);
+}
+
+TEST_F(PathfinderQueueTest, KeepsOrderWhileNodesArePushedDuringPop)
+{
+	nodes.resize(4);
+
+	nodes[0].setCost(1.0f);
+	queue.push(&nodes[0]);
+
+	ASSERT_EQ(queue.pop(), &nodes[0]);
+
+	nodes[1].setCost(3.0f);
+	nodes[2].setCost(1.5f);
+	nodes[3].setCost(1.0f);
+	queue.push(&nodes[1]);
+	queue.push(&nodes[2]);
+	queue.push(&nodes[3]);
+
+	EXPECT_EQ(popAll(), std::vector<float>({1.0f, 1.5f, 3.0f}));
+}
+
+TEST_F(PathfinderQueueTest, OutdatedEntriesAreSkipped)
+{
+	nodes.resize(3);
+
+	nodes[0].setCost(5.0f);
+	nodes[1].setCost(2.0f);
+	nodes[2].setCost(4.0f);
+	queue.push(&nodes[0]);
+	queue.push(&nodes[1]);
+	queue.push(&nodes[2]);
+
+	// node became cheaper and was pushed again
+	nodes[0].setCost(1.0f);
+	queue.push(&nodes[0]);
+
+	// node became more expensive while queued
+	nodes[1].setCost(6.0f);
+
+	EXPECT_EQ(popAll(), std::vector<float>({1.0f, 4.0f, 6.0f}));
+	EXPECT_FALSE(nodes[0].inPQ());
+	EXPECT_FALSE(nodes[1].inPQ());
+	EXPECT_FALSE(nodes[2].inPQ());
+}
@@ -0,0 +1,83 @@
+/*
+ * CMapGeneratorTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/mapping/CMap.h"
+#include "../../lib/mapObjects/CGObjectInstance.h"
+#include "../../lib/rmg/CMapGenOptions.h"
+#include "../../lib/rmg/CMapGenerator.h"
+#include "../../lib/RiverHandler.h"
+#include "../../lib/RoadHandler.h"
+#include "../../lib/TerrainHandler.h"
+
+namespace test
+{
+using namespace ::testing;
+
+static const int TEST_RANDOM_SEED = 1337;
+
+static size_t generateAndHash(unsigned int threads)
+{
+	CMapGenOptions opt;
+	opt.setHeight(CMapHeader::MAP_SIZE_MIDDLE);
+	opt.setWidth(CMapHeader::MAP_SIZE_MIDDLE);
+	opt.setHasTwoLevels(true);
+	opt.setHumanOrCpuPlayerCount(4);
+
+	CMapGenerator gen(opt, nullptr, TEST_RANDOM_SEED);
+	gen.setThreadCount(threads);
+	std::unique_ptr<CMap> map = gen.generate();
+
+	size_t hash = 0;
+	for(int z = 0; z < map->levels(); z++)
+	{
+		for(int y = 0; y < map->height; y++)
+		{
+			for(int x = 0; x < map->width; x++)
+			{
+				const auto & tile = map->getTile(int3(x, y, z));
+				boost::hash_combine(hash, tile.terType->getIndex());
+				boost::hash_combine(hash, tile.terView);
+				boost::hash_combine(hash, tile.riverType ? tile.riverType->getIndex() : -1);
+				boost::hash_combine(hash, tile.riverDir);
+				boost::hash_combine(hash, tile.roadType ? tile.roadType->getIndex() : -1);
+				boost::hash_combine(hash, tile.roadDir);
+				boost::hash_combine(hash, tile.extTileFlags);
+			}
+		}
+	}
+
+	for(const auto & object : map->objects)
+	{
+		boost::hash_combine(hash, object->id.getNum());
+		boost::hash_combine(hash, object->instanceName);
+		boost::hash_combine(hash, object->ID.getNum());
+		boost::hash_combine(hash, object->subID.getNum());
+		boost::hash_combine(hash, object->anchorPos().x);
+		boost::hash_combine(hash, object->anchorPos().y);
+		boost::hash_combine(hash, object->anchorPos().z);
+	}
+
+	boost::hash_combine(hash, map->grailPos.x);
+	boost::hash_combine(hash, map->grailPos.y);
+	boost::hash_combine(hash, map->grailPos.z);
+
+	return hash;
+}
+
+TEST(CMapGeneratorTest, sameMapForAnyThreadCount)
+{
+	const size_t singleThread = generateAndHash(1);
+
+	EXPECT_EQ(singleThread, generateAndHash(2));
+	EXPECT_EQ(singleThread, generateAndHash(std::max(4u, boost::thread::hardware_concurrency())));
+}
+
+}
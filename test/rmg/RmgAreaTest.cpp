@@ -0,0 +1,178 @@
+/*
+ * RmgAreaTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/rmg/RmgArea.h"
+
+namespace test
+{
+using namespace ::rmg;
+using namespace ::testing;
+
+static Tileset randomTiles(std::mt19937 & gen, const int3 & from, const int3 & to, int count)
+{
+	std::uniform_int_distribution<int> x(from.x, to.x);
+	std::uniform_int_distribution<int> y(from.y, to.y);
+	std::uniform_int_distribution<int> z(from.z, to.z);
+
+	Tileset tiles;
+	for(int i = 0; i < count; i++)
+		tiles.insert(int3(x(gen), y(gen), z(gen)));
+	return tiles;
+}
+
+static std::set<int3> sorted(const Tileset & tiles)
+{
+	return std::set<int3>(tiles.begin(), tiles.end());
+}
+
+static std::set<int3> sorted(const Area & area)
+{
+	return std::set<int3>(area.getTilesVector().begin(), area.getTilesVector().end());
+}
+
+TEST(RmgAreaTest, addEraseContains)
+{
+	Area area;
+	EXPECT_TRUE(area.empty());
+
+	area.add(int3(5, 5, 0));
+	area.add(int3(-70, 3, 1));
+	area.add(int3(130, -2, 0));
+
+	EXPECT_FALSE(area.empty());
+	EXPECT_TRUE(area.contains(int3(5, 5, 0)));
+	EXPECT_TRUE(area.contains(int3(-70, 3, 1)));
+	EXPECT_TRUE(area.contains(int3(130, -2, 0)));
+	EXPECT_FALSE(area.contains(int3(5, 5, 1)));
+	EXPECT_EQ(area.getTilesVector().size(), 3);
+
+	area.erase(int3(-70, 3, 1));
+	EXPECT_FALSE(area.contains(int3(-70, 3, 1)));
+	EXPECT_EQ(area.getTiles().size(), 2);
+}
+
+TEST(RmgAreaTest, setOperations)
+{
+	std::mt19937 gen(1337);
+
+	for(int i = 0; i < 50; i++)
+	{
+		auto left = randomTiles(gen, int3(-40, -10, 0), int3(150, 60, 1), 800);
+		auto right = randomTiles(gen, int3(-3, -20, 0), int3(100, 40, 1), 800);
+
+		std::set<int3> united = sorted(left);
+		std::set<int3> intersection, difference;
+		united.insert(right.begin(), right.end());
+		for(const auto & tile : left)
+		{
+			if(right.count(tile))
+				intersection.insert(tile);
+			else
+				difference.insert(tile);
+		}
+
+		EXPECT_EQ(sorted(Area(left) + Area(right)), united);
+		EXPECT_EQ(sorted(Area(left) * Area(right)), intersection);
+		EXPECT_EQ(sorted(Area(left) - Area(right)), difference);
+		EXPECT_EQ(Area(left).overlap(Area(right)), !intersection.empty());
+		EXPECT_TRUE((Area(left) + Area(right)).contains(Area(right)));
+		EXPECT_EQ(Area(left).contains(Area(right)), intersection.size() == right.size());
+	}
+}
+
+TEST(RmgAreaTest, translate)
+{
+	std::mt19937 gen(42);
+	auto tiles = randomTiles(gen, int3(0, 0, 0), int3(20, 20, 0), 100);
+	Area area(tiles);
+	Area other(tiles, int3(37, -5, 0));
+
+	area.translate(int3(37, -5, 0));
+	EXPECT_EQ(area, other);
+
+	for(const auto & tile : tiles)
+	{
+		EXPECT_TRUE(area.contains(tile + int3(37, -5, 0)));
+	}
+	EXPECT_EQ(sorted((area - int3(37, -5, 0)).getTiles()), sorted(tiles));
+}
+
+TEST(RmgAreaTest, borders)
+{
+	std::mt19937 gen(7);
+
+	for(int i = 0; i < 20; i++)
+	{
+		auto tiles = randomTiles(gen, int3(-5, -5, 0), int3(90, 40, 1), 2000);
+		Area area(tiles);
+
+		std::set<int3> border, borderOutside;
+		for(const auto & tile : tiles)
+		{
+			for(const auto & dir : int3::getDirs())
+			{
+				if(!tiles.count(tile + dir))
+				{
+					border.insert(tile);
+					borderOutside.insert(tile + dir);
+				}
+			}
+		}
+
+		EXPECT_EQ(sorted(area.getBorder()), border);
+		EXPECT_EQ(sorted(area.getBorderOutside()), borderOutside);
+	}
+}
+
+TEST(RmgAreaTest, connectedAreas)
+{
+	Area area;
+	//two diagonally touching squares and a separate line on other level
+	for(int x = 0; x < 3; x++)
+		for(int y = 0; y < 3; y++)
+			area.add(int3(x, y, 0));
+	for(int x = 3; x < 6; x++)
+		for(int y = 3; y < 6; y++)
+			area.add(int3(x, y, 0));
+	for(int x = 60; x < 140; x++)
+		area.add(int3(x, 10, 1));
+
+	EXPECT_FALSE(area.connected());
+	EXPECT_EQ(connectedAreas(area, false).size(), 2);
+	EXPECT_EQ(connectedAreas(area, true).size(), 3);
+
+	size_t total = 0;
+	for(const auto & component : connectedAreas(area, true))
+	{
+		EXPECT_TRUE(component.connected(true));
+		total += component.getTilesVector().size();
+	}
+	EXPECT_EQ(total, area.getTilesVector().size());
+}
+
+TEST(RmgAreaTest, distanceMap)
+{
+	Area area;
+	for(int x = 0; x < 5; x++)
+		for(int y = 0; y < 5; y++)
+			area.add(int3(x, y, 0));
+
+	std::map<int, Tileset> reverseDistanceMap;
+	auto distances = area.computeDistanceMap(reverseDistanceMap);
+
+	EXPECT_EQ(distances.size(), 25);
+	EXPECT_EQ(distances[int3(0, 0, 0)], 0);
+	EXPECT_EQ(distances[int3(1, 2, 0)], 1);
+	EXPECT_EQ(distances[int3(2, 2, 0)], 2);
+	EXPECT_EQ(reverseDistanceMap[0].size(), 16);
+}
+
+}
@@ -0,0 +1,170 @@
+/*
+ * RmgPathTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/rmg/RmgPath.h"
+
+namespace test
+{
+using namespace ::rmg;
+using namespace ::testing;
+
+static Tileset randomTiles(std::mt19937 & gen, const int3 & from, const int3 & to, int percent)
+{
+	std::uniform_int_distribution<int> chance(0, 99);
+
+	Tileset tiles;
+	for(int z = from.z; z <= to.z; z++)
+		for(int x = from.x; x <= to.x; x++)
+			for(int y = from.y; y <= to.y; y++)
+				if(chance(gen) < percent)
+					tiles.insert(int3(x, y, z));
+	return tiles;
+}
+
+static std::set<int3> sorted(const Area & area)
+{
+	return std::set<int3>(area.getTilesVector().begin(), area.getTilesVector().end());
+}
+
+struct PathSearchCase
+{
+	Area area;
+	int3 src;
+	int3 dst;
+	bool straight;
+};
+
+static std::vector<PathSearchCase> randomCases(int count)
+{
+	std::mt19937 gen(1337);
+	std::uniform_int_distribution<int> offset(-30, 60);
+	std::uniform_int_distribution<int> size(3, 50);
+	std::vector<PathSearchCase> cases;
+
+	for(int i = 0; i < count; i++)
+	{
+		int3 from(offset(gen), offset(gen), 0);
+		int3 to = from + int3(size(gen), size(gen), i % 2);
+		int3 src = from;
+		int3 dst = int3(to.x, to.y, from.z);
+
+		Tileset tiles = randomTiles(gen, from, to, 75);
+		tiles.insert(src);
+		tiles.insert(dst);
+
+		cases.push_back({Area(tiles), src, dst, i % 3 == 0});
+	}
+
+	return cases;
+}
+
+static std::vector<std::set<int3>> searchAll(const std::vector<PathSearchCase> & cases)
+{
+	std::vector<std::set<int3>> results;
+
+	for(const auto & searchCase : cases)
+	{
+		Path path(searchCase.area, searchCase.src);
+		results.push_back(sorted(path.search(searchCase.dst, searchCase.straight).getPathArea()));
+	}
+
+	return results;
+}
+
+TEST(RmgPathTest, resetDiscardsPreviousSearch)
+{
+	PathNodes nodes;
+
+	nodes.reset(int3(-10, -10, 0), int3(40, 40, 1));
+	for(int x = -10; x <= 40; x++)
+	{
+		for(int y = -10; y <= 40; y++)
+		{
+			nodes.update(int3(x, y, 1), static_cast<float>(x + y), int3(x, y, 0));
+			nodes.close(int3(x, y, 1));
+		}
+	}
+	nodes.queue().push(std::make_pair(int3(0, 0, 0), 0.f));
+
+	// smaller box with other origin maps its tiles onto entries used by previous search
+	nodes.reset(int3(5, 3, 0), int3(20, 12, 0));
+	EXPECT_TRUE(nodes.queue().empty());
+
+	for(int x = 5; x <= 20; x++)
+	{
+		for(int y = 3; y <= 12; y++)
+		{
+			EXPECT_FALSE(nodes.hasDistance(int3(x, y, 0)));
+			EXPECT_FALSE(nodes.isClosed(int3(x, y, 0)));
+		}
+	}
+
+	nodes.update(int3(7, 4, 0), 2.5f, int3(6, 4, 0));
+	EXPECT_TRUE(nodes.hasDistance(int3(7, 4, 0)));
+	EXPECT_EQ(nodes.getDistance(int3(7, 4, 0)), 2.5f);
+	EXPECT_EQ(nodes.getParent(int3(7, 4, 0)), int3(6, 4, 0));
+	EXPECT_FALSE(nodes.hasDistance(int3(8, 4, 0)));
+}
+
+TEST(RmgPathTest, straightCorridor)
+{
+	Tileset tiles;
+	for(int x = 0; x < 10; x++)
+		tiles.insert(int3(x, 0, 0));
+	tiles.insert(int3(5, 1, 0));
+
+	Area area(tiles);
+	Path path(area, int3(0, 0, 0));
+	auto result = path.search(int3(9, 0, 0), true);
+
+	EXPECT_TRUE(result.valid());
+	EXPECT_EQ(sorted(result.getPathArea()).size(), 10);
+	EXPECT_FALSE(result.getPathArea().contains(int3(5, 1, 0)));
+}
+
+TEST(RmgPathTest, unreachableDestination)
+{
+	Area area(Tileset{int3(0, 0, 0), int3(1, 0, 0), int3(5, 0, 0)});
+	Path path(area, int3(0, 0, 0));
+
+	EXPECT_FALSE(path.search(int3(5, 0, 0), true).valid());
+}
+
+TEST(RmgPathTest, reusedBuffersGiveSameResults)
+{
+	auto cases = randomCases(60);
+	std::vector<std::set<int3>> expected;
+
+	// each search in fresh thread gets newly allocated buffers
+	for(const auto & searchCase : cases)
+	{
+		boost::thread worker([&]()
+		{
+			expected.push_back(searchAll({searchCase}).front());
+		});
+		worker.join();
+	}
+
+	// successive searches over differently sized and placed boxes reuse buffers of this thread
+	auto reused = searchAll(cases);
+	std::reverse(cases.begin(), cases.end());
+	auto reusedReversed = searchAll(cases);
+	std::reverse(reusedReversed.begin(), reusedReversed.end());
+
+	ASSERT_EQ(expected.size(), reused.size());
+	for(size_t i = 0; i < expected.size(); i++)
+	{
+		EXPECT_EQ(expected[i], reused[i]) << "case " << i;
+		EXPECT_EQ(expected[i], reusedReversed[i]) << "case " << i;
+	}
+}
+
+}